@@ -1,163 +1,710 @@
 #include <inttypes.h>
+#include <avr/power.h>
 #include "OLED.h"
+#include "BitBang_TWI_Master.h"
+#include "BarsOnQuarters.h"
+#include "DeviceList.h"
+#include "ErrorTelemetry.h"
+#include "Filter.h"
 #include "GlyphsOnQuarter.h"
+#include "Sleep.h"
+#include "USDS.h"
+#include "USI_TWI_Async.h"
+#include "USI_TWI_Calibration.h"
 
-struct OLED_DEVICE {
-  static constexpr uint8_t ADDRESS { 0x3C };
+// Set to recalibrate the bus timing at boot, even if EEPROM holds settings.
+static constexpr bool RECALIBRATE = false;
+
+// Set to draw tear-free, showing only quarters A and B on the upper half of the panel.
+static constexpr bool DOUBLE_BUFFERED = false;
+
+// Set to show the distance of a single sensor four times as large, in centimeters,
+// on the whole panel (or its upper half, if double buffered) instead of everything else.
+static constexpr bool BIG_DISTANCE = false;
+
+// Where the calibrated settings are kept in EEPROM, 4 bytes per panel from EEPROM_OLED_DELAYS on,
+// 8 bytes per sensor from EEPROM_USDS_DELAYS on, and the error counts.
+static constexpr unsigned int EEPROM_OLED_DELAYS = 0;
+static constexpr unsigned int EEPROM_USDS_DELAYS = 8;
+static constexpr unsigned int EEPROM_ERROR_TELEMETRY = 64;
+
+// The engine of the display's bus: the USI, shared with the sensors, or a bus of its own
+// bit-banged on two other pins, e.g. BitBang_TWI_Bus<PORTB4, PORTB3>, so that they never
+// contend (on a Digispark, those pins also carry USB, which is idle once the sketch runs).
+// With USI_TWI_ASYNC, the USI sends to the display from interrupts, so that loop() formats
+// the next cells while the previous ones are on the bus, and returns before the last ones
+// went out, napping instead of spinning until the sensor's step needs the USI again.
+#if USI_TWI_ASYNC
+using OLED_BUS = USI_TWI_Async_Bus;
+#else
+using OLED_BUS = USI_TWI_Bus;
+#endif
+
+// A panel of the display, each calibrated on its own.
+// The delays set by hand are the starting point of calibration.
+template <uint8_t ADDR>
+struct OLED_PANEL {
+  using Bus = OLED_BUS;
+  static constexpr uint8_t ADDRESS { ADDR };
   static constexpr USI_TWI_Delay tHSTART { 0 };
   static constexpr USI_TWI_Delay tSSTOP { 0 };
-  static constexpr USI_TWI_Delay tIDLE { .6 };
+  static USI_TWI_Runtime_Delay tIDLE;
   static constexpr USI_TWI_Delay tPRE_SCL_HIGH { 0 };
   static constexpr USI_TWI_Delay tPOST_SCL_HIGH { 0 };
   static constexpr USI_TWI_Delay tPOST_TRANSFER { 0 };
+  static USI_TWI_Runtime_Delay* const DELAYS[1];
 };
+template <uint8_t ADDR> USI_TWI_Runtime_Delay OLED_PANEL<ADDR>::tIDLE { .6 };
+template <uint8_t ADDR> USI_TWI_Runtime_Delay* const OLED_PANEL<ADDR>::DELAYS[1] = {
+  &tIDLE
+};
+
+// The panels, all showing the same, e.g. a second one at 0x3D (with its address
+// jumper moved) for a readout on the other side of the enclosure. What they show
+// is formatted once, and each panel only receives the cells that changed on it.
+using PANELS = DeviceList<OLED_PANEL<0x3C>>;
+static_assert(PANELS::COUNT <= 2, "an SSD 1306 answers at 0x3C or 0x3D");
 
+// An ultrasonic distance sensor, each calibrated on its own.
+template <uint8_t ADDR>
 struct USDS_DEVICE {
-  static constexpr uint8_t ADDRESS { 0x57 };
+  static constexpr uint8_t ADDRESS { ADDR };
   static constexpr USI_TWI_Delay tHSTART { 0 };
   static constexpr USI_TWI_Delay tSSTOP { 0 };
-  static constexpr USI_TWI_Delay tIDLE { .6 };
-  static constexpr USI_TWI_Delay tPRE_SCL_HIGH { 3 };
-  static constexpr USI_TWI_Delay tPOST_SCL_HIGH { 1.5 };
+  static USI_TWI_Runtime_Delay tIDLE;
+  static USI_TWI_Runtime_Delay tPRE_SCL_HIGH;
+  static USI_TWI_Runtime_Delay tPOST_SCL_HIGH;
   static constexpr USI_TWI_Delay tPOST_TRANSFER { 0 };
+  static USI_TWI_Runtime_Delay* const DELAYS[3];
 };
+template <uint8_t ADDR> USI_TWI_Runtime_Delay USDS_DEVICE<ADDR>::tIDLE { .6 };
+template <uint8_t ADDR> USI_TWI_Runtime_Delay USDS_DEVICE<ADDR>::tPRE_SCL_HIGH { 3 };
+template <uint8_t ADDR> USI_TWI_Runtime_Delay USDS_DEVICE<ADDR>::tPOST_SCL_HIGH { 1.5 };
+template <uint8_t ADDR> USI_TWI_Runtime_Delay* const USDS_DEVICE<ADDR>::DELAYS[3] = {
+  &tIDLE, &tPRE_SCL_HIGH, &tPOST_SCL_HIGH
+};
+
+// The sensors, each displaying its distance in its own quarter, from A on.
+// Only one ranges at a time, lest they hear each other's echo, but the next one
+// is ordered as soon as a sample arrived, and ranges while that is displayed.
+// With a single sensor, quarter B shows the raw bytes of its samples, and
+// with up to two, quarters C and D show the trend of the first one,
+// or if tracing (see USI_TWI_Trace.h), its latest transaction and the display's.
+using SENSORS = DeviceList<USDS_DEVICE<0x57>>;
+static_assert(SENSORS::COUNT <= 4, "a quarter per sensor");
+static_assert(!DOUBLE_BUFFERED || SENSORS::COUNT == 1, "a flip shows a single sensor's update");
+static_assert(!BIG_DISTANCE || SENSORS::COUNT == 1, "a single sensor fills the panel");
+static constexpr bool SHOW_BYTES = SENSORS::COUNT == 1 && !BIG_DISTANCE;
+static constexpr bool SHOW_TRACE = USI_TWI_TRACE && SENSORS::COUNT <= 2 && !DOUBLE_BUFFERED && !BIG_DISTANCE;
+static constexpr bool SHOW_TREND = SENSORS::COUNT <= 2 && !DOUBLE_BUFFERED && !BIG_DISTANCE && !SHOW_TRACE;
+
+// Errors counted per device, error and location bucket, the 8 most frequent kinds
+// kept in 8 copies in EEPROM, and shown at boot. That takes 98 bytes of RAM, 45 of
+// them for the copy being written: fewer kinds would save 10 bytes each.
+using Telemetry = ErrorTelemetry<8, 8>;
+static_assert(alignof(uint32_t) != 1 || sizeof(Telemetry) == 98, "RAM as counted, where nothing is padded");
+static Telemetry telemetry { EEPROM_ERROR_TELEMETRY };
+static_assert(EEPROM_OLED_DELAYS + PANELS::COUNT * 4 <= EEPROM_USDS_DELAYS, "calibration fits");
+static_assert(EEPROM_USDS_DELAYS + SENSORS::COUNT * 8 <= EEPROM_ERROR_TELEMETRY, "calibration fits");
+static_assert(EEPROM_ERROR_TELEMETRY + Telemetry::EEPROM_BYTES <= E2END + 1, "error counts fit");
+
+// Like delay(), but asleep, powered down for the most part.
+static void rest(unsigned long ms) {
+  unsigned long const start = Sleep::millis();
+  for (unsigned long elapsed; (elapsed = Sleep::millis() - start) < ms;) {
+    Sleep::at_most(ms - elapsed);
+  }
+}
 
 static void flashN(uint8_t number) {
   while (number >= 5) {
     number -= 5;
-    delay(100);
+    rest(100);
     digitalWrite(LED_BUILTIN, HIGH);
-    delay(700);
+    rest(700);
     digitalWrite(LED_BUILTIN, LOW);
   }
   while (number >= 1) {
     number -= 1;
-    delay(100);
+    rest(100);
     digitalWrite(LED_BUILTIN, HIGH);
-    delay(200);
+    rest(200);
     digitalWrite(LED_BUILTIN, LOW);
   }
 }
 
-// Report an error while the display isn't set up.
-static void flashError(I2C::Status status) {
+// Report an error while the display isn't set up, after counting it for good.
+static void flashError(I2C::Status status, uint8_t address) {
   if (status.error) {
+    telemetry.count(address, status, Sleep::millis());
+    telemetry.flush();
     for (;;) {
-      delay(1200);
+      rest(1200);
       flashN(status.error);
-      delay(600);
+      rest(600);
       flashN(status.location);
     }
   }
 }
 
-// Report an error while we think we can display it.
-static void displayError(I2C::Status status) {
-  static uint8_t last_line = 0;
+// What's on display in the fields that are redrawn continuously, per panel,
+// and per half of RAM if double buffered.
+static GlyphCache<10> millimeter_cells[PANELS::COUNT][SENSORS::COUNT][1 + DOUBLE_BUFFERED];
+static GlyphCache<6> bytes_cells[PANELS::COUNT][1 + DOUBLE_BUFFERED];
+static GlyphCache<3> big_cells[PANELS::COUNT][1 + DOUBLE_BUFFERED];
+
+static OLED::DoubleBuffer frames[PANELS::COUNT];
+
+// Index of the caches of the RAM drawn in.
+static uint8_t drawn_half(uint8_t panel) {
+  return DOUBLE_BUFFERED ? frames[panel].hidden_half() : 0;
+}
+
+// Where to draw what is to be seen in a quarter of the panel.
+static OLED::Quarter drawn_quarter(uint8_t panel, OLED::Quarter quarter) {
+  return DOUBLE_BUFFERED ? frames[panel].in_hidden(quarter) : quarter;
+}
+
+// How to draw the heartbeat on the panel, so that it toggles with every frame.
+static OLED::Heartbeat drawn_heartbeat(uint8_t panel) {
+  return DOUBLE_BUFFERED ? frames[panel].heartbeat() : OLED::Heartbeat::Toggled;
+}
+
+// Proportional font for text. Only the glyphs up to '@' are stored, for text composed
+// at run time; the others are merely used in labels laid out at compile time.
+static constexpr char const* const TEXT_GLYPHS[] = {
+  GlyphArt::DEC_DIGITS[0], GlyphArt::DEC_DIGITS[1], GlyphArt::DEC_DIGITS[2], GlyphArt::DEC_DIGITS[3],
+  GlyphArt::DEC_DIGITS[4], GlyphArt::DEC_DIGITS[5], GlyphArt::DEC_DIGITS[6], GlyphArt::DEC_DIGITS[7],
+  GlyphArt::DEC_DIGITS[8], GlyphArt::DEC_DIGITS[9], GlyphArt::ABCDEF[0], GlyphArt::ABCDEF[1],
+  GlyphArt::ABCDEF[2], GlyphArt::ABCDEF[3], GlyphArt::ABCDEF[4], GlyphArt::ABCDEF[5],
+  nullptr, GlyphArt::AT, GlyphArt::POINT, GlyphArt::LOWER_E, GlyphArt::LOWER_M, GlyphArt::LOWER_R
+};
+static constexpr FontArt TEXT_ART = { "0123456789ABCDEF @.emr", TEXT_GLYPHS, sizeof TEXT_GLYPHS / sizeof *TEXT_GLYPHS, 3 };
+static constexpr FontArt STORED_TEXT_ART = { TEXT_ART.chars, TEXT_ART.art, 18, TEXT_ART.blank_width };
+static Font<STORED_TEXT_ART.count, font_columns(STORED_TEXT_ART)> PROGMEM const TEXT_FONT { STORED_TEXT_ART };
+
+// The static parts of the fields, laid out at compile time.
+static constexpr LabelPiece ERROR_LAYOUT[] = {
+  LabelPiece::blank(3), LabelPiece::text(TEXT_ART, "err"), LabelPiece::blank(1)
+};
+static constexpr LabelPiece AT_LAYOUT[] = {
+  LabelPiece::blank(3), LabelPiece::text(TEXT_ART, "@")
+};
+static constexpr LabelPiece METER_LAYOUT[] = {
+  LabelPiece::blank(2), LabelPiece::text(TEXT_ART, "m")
+};
+static QuarterLabel<label_width(ERROR_LAYOUT)> PROGMEM const ERROR_LABEL { ERROR_LAYOUT };
+static QuarterLabel<label_width(AT_LAYOUT)> PROGMEM const AT_LABEL { AT_LAYOUT };
+static QuarterLabel<label_width(METER_LAYOUT)> PROGMEM const METER_LABEL { METER_LAYOUT };
+
+// Lines formatted once for all panels, a cell per glyph, run or label.
+using ErrorLine = GlyphLine<8>;
+using MillimeterLine = GlyphLine<10>;
+using BytesLine = GlyphLine<6>;
+using BigLine = GlyphLine<3, 4>;
+using TraceLine = GlyphLine<16>;
+static_assert(ErrorLine::CAPACITY >= 1 + ErrorLine::numberCells(3) + 1 + ErrorLine::numberCells(3), "error line kept");
+static_assert(MillimeterLine::CAPACITY >= MillimeterLine::numberCells(5, 3) + 1, "distance kept");
+static_assert(BytesLine::CAPACITY >= 3 * BytesLine::numberCells(2), "bytes kept");
+static_assert(BigLine::CAPACITY >= BigLine::numberCells(3), "big distance kept");
+static_assert(TraceLine::CAPACITY >= 4 * TraceLine::numberCells(2) + 4 + TraceLine::numberCells(4), "trace kept");
+static_assert(ERROR_LABEL.WIDTH + ErrorLine::numberWidth(3) + AT_LABEL.WIDTH + ErrorLine::numberWidth(3) <= OLED::WIDTH,
+              "error line fits");
+
+template <typename Panel>
+using Field = GlyphsOnQuarter<Panel>;
+template <typename Panel>
+using BigField = GlyphsOnPages<Panel, (DOUBLE_BUFFERED ? OLED::DoubleBuffer::ROWS : OLED::HEIGHT) / 8, 4>;
+
+template <typename Device>
+struct AddressOf {
+  static uint8_t run() {
+    return Device::ADDRESS;
+  }
+};
+
+// How a transaction with a panel went, once it's over, for what must know before going
+// on: with USI_TWI_ASYNC, stop() returns while the frame is still on the bus.
+template <typename Panel>
+static I2C::Status finished(I2C::Status status) {
+  if (!status.error) status.error = I2C::result<Panel>();
+  return status;
+}
+
+template <typename Panel>
+struct DrawError {
+  static void run(uint8_t panel, ErrorLine const& line) {
+    uint8_t const half = DOUBLE_BUFFERED ? frames[panel].shown_half() : 0;
+    OLED::Quarter const quarter = DOUBLE_BUFFERED ? frames[panel].in_shown(OLED::Quarter::B) : OLED::Quarter::B;
+    if (BIG_DISTANCE) {
+      big_cells[panel][half].invalidate();
+    } else if (SHOW_BYTES) {
+      bytes_cells[panel][half].invalidate();
+    } else {
+      for (uint8_t sensor = 0; sensor < SENSORS::COUNT; ++sensor) {
+        if (OLED::Quarter(sensor) == OLED::Quarter::B) {
+          millimeter_cells[panel][sensor][half].invalidate();
+        }
+      }
+    }
+    auto chat = Field<Panel> {0, quarter};
+    chat.send(line);
+    chat.stop();
+  }
+};
+
+// Report an error while we think we can display it, in quarter B of each panel,
+// since C and D hold the trend, other sensors or, if double buffered, the hidden half.
+// If double buffered, it's drawn straight in the half shown.
+static void displayError(I2C::Status status, uint8_t address) {
   if (status.error) {
-    if (++last_line == 4) last_line = 1;
-    auto chat = GlyphsOnQuarter<OLED_DEVICE> {0, OLED::Quarter(last_line)};
-    chat.send(0, 3);
-    chat.send(GlyphPair::err.left);
-    chat.send(GlyphPair::err.right);
-    chat.send3dec(status.error);
-    chat.send(0, 3);
-    chat.send(Glyph::at);
-    chat.send3dec(status.location);
-  }
-}
-
-static void displayMillimeter(OLED::Quarter quarter, uint16_t value) {
-  uint8_t constexpr width = Glyph::DIGIT_WIDTH * 5 + Glyph::POINT_WIDTH + GlyphPair::WIDTH;
-  auto chat = GlyphsOnQuarter<OLED_DEVICE> {10, quarter, 0, uint8_t(width - 1)};
-  uint8_t decimal3 = value % 10;
-  value /= 10;
-  uint8_t decimal2 = value % 10;
-  value /= 10;
-  uint8_t decimal1 = value % 10;
-  value /= 10;
-  uint8_t unit = value % 10;
-  value /= 10;
-  if (value == 0) {
-    chat.send(0, Glyph::DIGIT_WIDTH);
-  } else if (value < 10) {
-    chat.send(Glyph::dec_digit[value]);
-  } else {
-    chat.send(~0, Glyph::DIGIT_WIDTH);
+    telemetry.count(address, status, Sleep::millis());
+    ErrorLine line;
+    line.send(ERROR_LABEL);
+    line.send3dec(status.error);
+    line.send(AT_LABEL);
+    line.send3dec(status.location);
+    for (uint8_t panel = 0; panel < PANELS::COUNT; ++panel) {
+      PANELS::apply<DrawError>(panel, panel, line);
+    }
+  }
+}
+
+// Draw on each panel, through Draw<Panel>::run(panel, args...), and report its errors.
+template <template <typename> class Draw, typename... Args>
+static void displayOnPanels(Args const&... args) {
+  for (uint8_t panel = 0; panel < PANELS::COUNT; ++panel) {
+    displayError(PANELS::apply<Draw>(panel, panel, args...), PANELS::apply<AddressOf>(panel));
+  }
+}
+
+template <typename Panel>
+struct DrawMillimeter {
+  static I2C::Status run(uint8_t panel, uint8_t sensor, MillimeterLine const& line) {
+    uint8_t constexpr width = 1 + MillimeterLine::numberWidth(5, 3) + METER_LABEL.WIDTH;
+    static_assert(width <= OLED::WIDTH, "distance fits");
+    auto chat = Field<Panel> {10, drawn_quarter(panel, OLED::Quarter(sensor)), millimeter_cells[panel][sensor][drawn_half(panel)], 0, uint8_t(width - 1), drawn_heartbeat(panel)};
+    chat.send(line);
+    return chat.stop();
+  }
+};
+
+// Display a distance given in micrometers, in meters with three decimals, in the sensor's quarter.
+static void displayMillimeter(uint8_t sensor, uint32_t micrometers) {
+  MillimeterLine line;
+  line.sendNumber<10, 5, 3, false, 3>(micrometers + 500); // rounded to millimeters
+  line.send(METER_LABEL);
+  displayOnPanels<DrawMillimeter>(sensor, line);
+}
+
+template <typename Panel>
+struct DrawBigDistance {
+  static I2C::Status run(uint8_t panel, BigLine const& line) {
+    uint8_t constexpr width = 4 + BigLine::numberWidth(3); // including the heartbeat
+    static_assert(width <= OLED::WIDTH, "big distance fits");
+    uint8_t constexpr xBegin = (OLED::WIDTH - width) / 2;
+    auto chat = BigField<Panel> {10, uint8_t(drawn_half(panel) * OLED::DoubleBuffer::ROWS / 8), big_cells[panel][drawn_half(panel)], xBegin, xBegin + width - 1, drawn_heartbeat(panel)};
+    chat.send(line);
+    return chat.stop();
+  }
+};
+
+// Display a distance given in micrometers, in centimeters, centered on the panel.
+static void displayBigDistance(uint32_t micrometers) {
+  BigLine line;
+  line.sendNumber<10, 3, 0, false, 4>(micrometers + 5000); // rounded to centimeters
+  displayOnPanels<DrawBigDistance>(line);
+}
+
+template <typename Panel>
+struct DrawTrend {
+  static I2C::Status run(uint8_t, uint32_t micrometers) {
+    auto chat = BarsOnQuarters<Panel> {40, OLED::Quarter::C, OLED::Quarter::D};
+    uint32_t const pixels = micrometers >> 17;
+    chat.sendBar(pixels > chat.height() ? chat.height() : uint8_t(pixels));
+    return chat.stop();
+  }
+};
+
+// Scroll the trend graph along with a bar for a distance given in micrometers,
+// reaching the top at 2^22 µm, i.e. about 4.2 m, just beyond the sensor's range.
+static void displayTrend(uint32_t micrometers) {
+  displayOnPanels<DrawTrend>(micrometers);
+}
+
+#if USI_TWI_TRACE
+// What's on display of the latest transactions, per panel, in quarters C and D,
+// so that the trace doesn't mostly record its own drawing. 96 bytes of RAM per panel.
+static GlyphCache<16> trace_cells[PANELS::COUNT][2];
+
+template <typename Panel>
+struct DrawTrace {
+  static I2C::Status run(uint8_t panel, OLED::Quarter quarter, TraceLine const& line) {
+    auto chat = Field<Panel> {50, quarter, trace_cells[panel][quarter == OLED::Quarter::D]};
+    chat.send(line);
+    return chat.stop();
+  }
+};
+
+// Display the latest transaction with a device, in hex: its address, outcome,
+// retries, data bytes and duration in ticks of 4 µs.
+static void displayTrace(OLED::Quarter quarter, uint8_t address) {
+  USI_TWI_Trace_Record const* const latest = USI_TWI_Trace_Latest(address);
+  if (latest) {
+    TraceLine line; // before the panels' transactions are traced
+    line.send2hex(latest->address);
+    line.send(0, 2);
+    line.send2hex(latest->error);
+    line.send(0, 2);
+    line.send2hex(latest->retries);
+    line.send(0, 2);
+    line.send2hex(latest->bytes);
+    line.send(0, 2);
+    line.send4hex(latest->duration);
+    displayOnPanels<DrawTrace>(quarter, line);
+  }
+}
+#endif
+
+// Have everything on a panel drawn from scratch, since some of it may not have arrived.
+static void forget(uint8_t panel) {
+  for (auto& halves : millimeter_cells[panel]) {
+    for (auto& cells : halves) cells.invalidate();
   }
-  chat.send(Glyph::dec_digit[unit]);
-  chat.sendPoint();
-  chat.send(Glyph::dec_digit[decimal1]);
-  chat.send(Glyph::dec_digit[decimal2]);
-  chat.send(Glyph::dec_digit[decimal3]);
-  chat.send(GlyphPair::m.left);
-  chat.send(GlyphPair::m.right);
-  displayError(chat.stop());
+  for (auto& cells : bytes_cells[panel]) cells.invalidate();
+  for (auto& cells : big_cells[panel]) cells.invalidate();
+#if USI_TWI_TRACE
+  for (auto& cells : trace_cells[panel]) cells.invalidate();
+#endif
 }
 
-static void order_sample() {
-  for (;;) {
-    auto err = I2C::Chat<USDS_DEVICE> {7} .send(1).stop();
-    switch (err.error) {
-      case USI_TWI_OK: return;
-      case USI_TWI_NO_ACK_ON_ADDRESS: continue;
-      default: displayError(err);
+// Wait for the frames still going out to a panel, and report if any failed after its
+// stop() returned, at location 60. The error line's own outcome is ignored, as when
+// it's drawn for an error reported right away.
+template <typename Panel>
+struct CollectFrames {
+  static void run(uint8_t panel) {
+    if (auto err = I2C::result<Panel>()) {
+      forget(panel);
+      displayError(I2C::Status { err, 60 }, Panel::ADDRESS);
+      I2C::result<Panel>();
     }
   }
+};
+
+// Before the sensors use the USI, which the display's engine may be sending on,
+// and before sleeping deeper than that engine's interrupts allow.
+static void collectFrames() {
+  for (uint8_t panel = 0; panel < PANELS::COUNT; ++panel) {
+    PANELS::apply<CollectFrames>(panel, panel);
+  }
 }
 
-static void displayBytes(OLED::Quarter quarter, uint8_t buf[3]) {
-  uint8_t constexpr width = 6 * Glyph::DIGIT_WIDTH;
-  auto chat = GlyphsOnQuarter<OLED_DEVICE> {20, quarter, OLED::WIDTH - width, OLED::WIDTH - 1, false};
-  chat.send2hex(buf[0]);
-  chat.send2hex(buf[1]);
-  chat.send2hex(buf[2]);
-  displayError(chat.stop());
+template <typename Device>
+struct InitialiseBus {
+  static void run() {
+    I2C::BusOf<Device>::type::Initialise();
+  }
+};
+
+template <typename Device>
+struct OrderSample {
+  static void run() {
+    for (;;) {
+      collectFrames();
+      auto err = I2C::Chat<Device> {7} .send(1).stop();
+      switch (err.error) {
+        case USI_TWI_OK: return;
+        case USI_TWI_NO_ACK_ON_ADDRESS: continue;
+        default: displayError(err, Device::ADDRESS);
+      }
+    }
+  }
+};
+
+template <typename Panel>
+struct DrawBytes {
+  static I2C::Status run(uint8_t panel, OLED::Quarter quarter, BytesLine const& line) {
+    uint8_t constexpr width = 6 * Glyph::DIGIT_WIDTH;
+    auto chat = Field<Panel> {20, drawn_quarter(panel, quarter), bytes_cells[panel][drawn_half(panel)], OLED::WIDTH - width, OLED::WIDTH - 1, OLED::Heartbeat::None};
+    chat.send(line);
+    return chat.stop();
+  }
+};
+
+static void displayBytes(OLED::Quarter quarter, uint8_t const buf[3]) {
+  BytesLine line;
+  line.send2hex(buf[0]);
+  line.send2hex(buf[1]);
+  line.send2hex(buf[2]);
+  displayOnPanels<DrawBytes>(quarter, line);
 }
 
-static void await_reception(uint8_t buf[], size_t len) {
-  // In practice the module responds in at most 156 ms, depending on the distance measured.
-  for (;;) {
-    delay(10);
-    auto err = USI_TWI_Master_Receive<USDS_DEVICE>(buf, len);
+template <typename Panel>
+struct Flip {
+  static I2C::Status run(uint8_t panel) {
+    return frames[panel].flip<Panel>(30);
+  }
+};
+
+// Try to collect the sample ordered, telling whether it has arrived.
+template <typename Device>
+struct ReceiveSample {
+  static bool run(uint8_t buf[], size_t len) {
+    collectFrames();
+    auto err = I2C::receive<Device>(buf, len);
     switch (err) {
-      case USI_TWI_OK: return;
-      case USI_TWI_NO_ACK_ON_ADDRESS: continue;
-      default: displayError(I2C::Status { err, 15 });
+      case USI_TWI_OK: return true;
+      case USI_TWI_NO_ACK_ON_ADDRESS: return false; // still ranging
+      default: displayError(I2C::Status { err, 15 }, Device::ADDRESS); return false;
+    }
+  }
+};
+
+static uint32_t micrometers(uint8_t const buf[3]) {
+  // It's not worth while to have the 3rd byte of the micrometer value, but the device
+  // gets angry if we don't read all three.
+  return uint32_t(buf[0]) << 16 | uint32_t(buf[1]) << 8 | uint32_t(buf[2]);
+}
+
+// Samples pass a median of 3, then an average in which each weighs 1/4, and are
+// only displayed once that moved at least 2 mm, rather than jitter on display
+// (host/filter_traces.cpp replays recorded samples through it). That takes 26 bytes
+// of RAM per sensor: 13 for the median, 4 for the average, 4 for the value displayed,
+// 4 for the latest average and 1 to tell whether it got a sample yet.
+using SensorFilter = SampleFilter<3, 2, 2000>;
+static_assert(alignof(uint32_t) != 1 || sizeof(SensorFilter) == 26, "RAM as counted, where nothing is padded");
+static SensorFilter filters[SENSORS::COUNT];
+
+// Display the filtered distance of a sensor, along with what else it shows.
+static void displaySample(uint8_t sensor, uint8_t const buf[3]) {
+  SensorFilter& filter = filters[sensor];
+  if (filter.add(micrometers(buf))) {
+    if (SHOW_BYTES) {
+      displayBytes(OLED::Quarter::B, buf);
+    }
+    if (BIG_DISTANCE) {
+      displayBigDistance(filter.value());
+    } else {
+      displayMillimeter(sensor, filter.value());
+    }
+    if (DOUBLE_BUFFERED) {
+      displayOnPanels<Flip>();
+    }
+  }
+  if (SHOW_TREND && sensor == 0) {
+    displayTrend(filter.smoothed());
+  }
+#if USI_TWI_TRACE
+  if (SHOW_TRACE && sensor == 0) {
+    displayTrace(OLED::Quarter::C, SENSORS::apply<AddressOf>(sensor));
+    displayTrace(OLED::Quarter::D, PANELS::apply<AddressOf>(0));
+  }
+#endif
+}
+
+// When to read the sample ordered, per sensor.
+static USDS::ReadySchedule schedules[SENSORS::COUNT];
+
+// Two harmless conversations in a row, so that the idle time between them matters too.
+// The display can't be read, so what's checked is that the bus carried every byte
+// as sent (else USI_TWI_UE_DATA_COL), the same at any setting, and that the display
+// acknowledged it.
+template <typename Panel>
+static bool probe_oled(bool) {
+  return !finished<Panel>(OLED::Chat<Panel> {0} .set_contrast(255).stop()).error
+         && !finished<Panel>(OLED::Chat<Panel> {0} .set_contrast(255).stop()).error;
+}
+
+// A sample ordered and received in one transaction, within the 156 ms it should take at most,
+// that is a distance the sensor measures, and agrees with the reference sample taken at
+// settings known to work. Delays too short for the sensor garble the bits it sends, and
+// nothing else tells, since it's the master that acknowledges them.
+template <typename Device>
+class ProbeSensor {
+    uint32_t reference = 0;
+
+  public:
+    bool operator()(bool take_reference) {
+      uint8_t buf[3];
+      if (I2C::Chat<Device> {0} .send(1).receiveWhenReady(buf, sizeof buf, 40, 5).stop().error) {
+        return false;
+      }
+      uint32_t const sample = micrometers(buf);
+      if (sample > USDS::MAX_MICROMETERS) {
+        return false;
+      }
+      if (take_reference) {
+        reference = sample;
+      }
+      return sample + USDS::JITTER >= reference && sample <= reference + USDS::JITTER;
+    }
+};
+
+// Restore the fastest timing each device was found to cope with,
+// or find it now, which takes several seconds, and keep it unless the device failed us.
+template <size_t N, typename Probe>
+static void calibrate(unsigned int eeprom_address, USI_TWI_Runtime_Delay* const (&delays)[N], Probe probe) {
+  if (RECALIBRATE || !USI_TWI_Load_Delays(eeprom_address, delays, N)) {
+    bool calibrated = true;
+    for (USI_TWI_Runtime_Delay* delay : delays) {
+      calibrated &= USI_TWI_Calibrate(*delay, probe);
+    }
+    if (calibrated) {
+      USI_TWI_Store_Delays(eeprom_address, delays, N);
+    }
+  }
+}
+
+template <typename Panel>
+struct CalibratePanel {
+  static void run(unsigned int eeprom_address) {
+    calibrate(eeprom_address, Panel::DELAYS, probe_oled<Panel>);
+  }
+};
+
+template <typename Device>
+struct CalibrateSensor {
+  static void run(unsigned int eeprom_address) {
+    calibrate(eeprom_address, Device::DELAYS, ProbeSensor<Device>());
+  }
+};
+
+template <typename Panel>
+struct DrawText {
+  static I2C::Status run(uint8_t, OLED::Quarter quarter, char const* text) {
+    auto chat = Field<Panel> {0, quarter};
+    chat.send(TEXT_FONT, text);
+    return finished<Panel>(chat.stop());
+  }
+};
+
+// Display the most frequent kinds of error counted so far, one per quarter shown,
+// for a while: device address in hex, error, location bucket and count.
+// Tell whether there were any.
+static bool displayTelemetry() {
+  uint8_t constexpr lines = DOUBLE_BUFFERED ? 2 : 4;
+  uint8_t line = 0;
+  for (; line < lines && telemetry[line].count != 0; ++line) {
+    Telemetry::Entry const& entry = telemetry[line];
+    char text[16]; // e.g. "57 3@120 1234"
+    char* end = Digits<16, 2>(entry.address).text(text, 2);
+    *end++ = ' ';
+    end = Digits<10, 3>(entry.error).text(end);
+    *end++ = '@';
+    end = Digits<10, 3>(uint8_t(entry.bucket << Telemetry::BUCKET_SHIFT)).text(end);
+    *end++ = ' ';
+    end = Digits<10, 5>(entry.count).text(end);
+    *end = '\0';
+    for (uint8_t panel = 0; panel < PANELS::COUNT; ++panel) {
+      flashError(PANELS::apply<DrawText>(panel, panel, OLED::Quarter(line), text), PANELS::apply<AddressOf>(panel));
     }
   }
+  if (line == 0) return false;
+  rest(4000);
+  return true;
 }
 
+template <typename Panel>
+struct SetUpPanel {
+  static I2C::Status run() {
+    return finished<Panel>(OLED::Chat<Panel> {0}
+           .init()
+           .set_addressing_mode(OLED::VerticalAddressing)
+           .set_column_address()
+           .set_page_address()
+           .set_contrast(255)
+           .set_multiplex(DOUBLE_BUFFERED ? OLED::DoubleBuffer::ROWS : OLED::HEIGHT)
+           .set_com_pins() // whatever it was before a reset, lest half the rows spread over the panel
+           .set_enabled()
+           .start_data()
+           .sendN(OLED::BYTES, 0)
+           .stop());
+  }
+};
+
+template <typename Panel>
+struct ClearPanel {
+  static I2C::Status run() {
+    return finished<Panel>(OLED::Chat<Panel> {0}
+           .set_column_address()
+           .set_page_address()
+           .start_data()
+           .sendN(OLED::BYTES, 0)
+           .stop());
+  }
+};
+
 void setup() {
   pinMode(LED_BUILTIN, OUTPUT);
   digitalWrite(LED_BUILTIN, HIGH);
-  USI_TWI_Master_Initialise();
-  auto err = OLED::Chat<OLED_DEVICE> {0}
-             .init()
-             .set_addressing_mode(OLED::VerticalAddressing)
-             .set_column_address()
-             .set_page_address()
-             .set_contrast(255)
-             .set_enabled()
-             .start_data()
-             .sendN(OLED::BYTES, 0)
-             .stop();
+  ADCSRA = 0; // the ADC is unused, and would draw current in power-down
+  power_adc_disable();
+  telemetry.load();
+  for (uint8_t panel = 0; panel < PANELS::COUNT; ++panel) {
+    PANELS::apply<InitialiseBus>(panel);
+  }
+  for (uint8_t sensor = 0; sensor < SENSORS::COUNT; ++sensor) {
+    SENSORS::apply<InitialiseBus>(sensor);
+  }
+  for (uint8_t panel = 0; panel < PANELS::COUNT; ++panel) {
+    PANELS::apply<CalibratePanel>(panel, EEPROM_OLED_DELAYS + panel * 4u);
+  }
+  for (uint8_t sensor = 0; sensor < SENSORS::COUNT; ++sensor) {
+    SENSORS::apply<CalibrateSensor>(sensor, EEPROM_USDS_DELAYS + sensor * 8u);
+  }
+  I2C::Status errs[PANELS::COUNT];
+  for (uint8_t panel = 0; panel < PANELS::COUNT; ++panel) {
+    errs[panel] = PANELS::apply<SetUpPanel>(panel);
+  }
   digitalWrite(LED_BUILTIN, LOW);
-  flashError(err);
+  for (uint8_t panel = 0; panel < PANELS::COUNT; ++panel) {
+    flashError(errs[panel], PANELS::apply<AddressOf>(panel));
+  }
+  if (displayTelemetry()) {
+    for (uint8_t panel = 0; panel < PANELS::COUNT; ++panel) {
+      flashError(PANELS::apply<ClearPanel>(panel), PANELS::apply<AddressOf>(panel));
+    }
+  }
 }
 
+// Each call does one step of the measurement pipeline, without waiting:
+// either order the next sample and display the previous one while the sensor
+// is ranging, or check whether the sample ordered has arrived, if it's due,
+// or else sleep until it is. The sensors take turns. With USI_TWI_ASYNC, the
+// frames displayed go out while the following steps run, and the sensors'
+// steps wait for them to end, asleep, since they share the USI.
 void loop() {
-  order_sample();
+  static uint8_t bufs[SENSORS::COUNT][3];
+  static uint8_t sensor = 0;    // the one ranging, or to order next
+  static uint8_t previous = 0;  // the one whose sample arrived last
+  static bool received = false; // its sample wasn't displayed yet
+  static bool ranging = false;
 
-  uint8_t buf[3];
-  digitalWrite(LED_BUILTIN, HIGH);
-  await_reception(buf, sizeof buf);
-  digitalWrite(LED_BUILTIN, LOW);
-  displayBytes(OLED::Quarter::B, buf);
-  // It's not worth while to have the 3rd byte of the micrometer value, but the device
-  // gets angry if we don't read all three. And we need more than 16 bits to scale the
-  // number using integer arithmetic.
-  uint32_t distance = uint32_t(buf[0]) << 16 | uint32_t(buf[1]) << 8 | uint32_t(buf[2]);
-  displayMillimeter(OLED::Quarter::A, uint16_t((distance + 500) / 1000)); // ųm to mm
-  delay(500);
+  if (!ranging) {
+    SENSORS::apply<OrderSample>(sensor);
+    ranging = true;
+    schedules[sensor].ordered(Sleep::millis(), micrometers(bufs[sensor]));
+    digitalWrite(LED_BUILTIN, HIGH);
+    if (received) {
+      received = false;
+      displaySample(previous, bufs[previous]);
+    }
+  } else if (schedules[sensor].due(Sleep::millis())) {
+    if (SENSORS::apply<ReceiveSample>(sensor, bufs[sensor], sizeof bufs[sensor])) {
+      schedules[sensor].arrived();
+      ranging = false;
+      received = true;
+      previous = sensor;
+      if (++sensor == SENSORS::COUNT) sensor = 0;
+      digitalWrite(LED_BUILTIN, LOW);
+    } else {
+      schedules[sensor].refused(Sleep::millis());
+    }
+  } else {
+    collectFrames();
+    unsigned long const now = Sleep::millis();
+    telemetry.maintain(now);
+    Sleep::at_most(schedules[sensor].until(now));
+  }
 }
@@ -0,0 +1,48 @@
+#pragma once
+#include "OLED.h"
+
+// Bar graph over consecutive quarters, e.g. the trend of a measurement.
+// Adding a bar has the SSD 1306 itself scroll the graph one column to the left,
+// so only the new column on the right is sent: 4 data bytes on top of
+// 13 command bytes for two quarters, instead of redrawing 256 bytes.
+template <typename Device>
+class BarsOnQuarters : public OLED::Chat<Device> {
+    using super = OLED::Chat<Device>;
+  private:
+    uint8_t const first_page;
+    uint8_t const last_page;
+
+  public:
+    // start_location is merely the initial value of a counter for error reporting.
+    explicit BarsOnQuarters(uint8_t start_location, OLED::Quarter first, OLED::Quarter last)
+      : super(start_location)
+      , first_page(static_cast<uint8_t>(first) * 2)
+      , last_page(static_cast<uint8_t>(last) * 2 + 1) {
+    }
+
+    // Number of pixels of a bar reaching from bottom to top.
+    uint8_t height() const {
+      return (last_page - first_page + 1) * 8;
+    }
+
+    // Scroll the graph and draw a bar of so many pixels high (up to height())
+    // in the rightmost column. You can only stop this chat after this.
+    I2C::Chat<Device>& sendBar(uint8_t pixels) {
+      auto& chat = super::scroll_content(OLED::ScrollLeft, first_page, last_page)
+                   .set_page_address(first_page, last_page)
+                   .set_column_address(OLED::WIDTH - 1, OLED::WIDTH - 1)
+                   .start_data();
+      // Pixels that remain dark above the bar, leaving whole pages to skip.
+      uint8_t dark = height() - pixels;
+      for (uint8_t page = first_page; page <= last_page; ++page) {
+        if (dark >= 8) {
+          chat.send(0);
+          dark -= 8;
+        } else {
+          chat.send(byte(0xFF << dark));
+          dark = 0;
+        }
+      }
+      return chat;
+    }
+};
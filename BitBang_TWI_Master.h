@@ -0,0 +1,255 @@
+#pragma once
+#include "USI_TWI_Master.h"
+
+/*****************************************************************************
+  I2C master bit-banged on any two pins of the port the USI is on (any pins
+  of an ATtiny85), as an alternative bus engine to USI_TWI_Bus for the same
+  devices: it takes the same Device concept and its delays, reports the same
+  errors (except those only the USI's flags can tell) and is traced the same.
+
+  The lines are driven open-drain, pulled low by making the pin an output
+  (its PORT bit stays cleared) and released by making it an input, so each
+  line needs a pull-up resistor, as the modules usually have.
+  Each edge is a single sbi/cbi instruction once the pins are constants.
+****************************************************************************/
+
+template <unsigned char SDA, unsigned char SCL>
+class BitBang_TWI_Bus {
+    static_assert(SDA != SCL, "two pins");
+
+    static void Pull_SDA_Low() {
+      DDR_USI |= (1 << SDA);
+    }
+
+    static void Release_SDA() {
+      DDR_USI &= ~(1 << SDA);
+    }
+
+    static void Pull_SCL_Low() {
+      DDR_USI |= (1 << SCL);
+    }
+
+    static bool SDA_High() {
+      return PIN_USI & (1 << SDA);
+    }
+
+    // Release SCL and wait until it's high, as USI_TWI_Await_SCL_High.
+    static bool Release_SCL() {
+      DDR_USI &= ~(1 << SCL);
+      for (USI_TWI_Int<uint32_t> polls = USI_TWI_TIMEOUT.count() / 8; polls != 0; --polls) {
+        if (PIN_USI & (1 << SCL)) {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    // Free the bus after a timeout, as USI_TWI_Master_Recover.
+    static USI_TWI_ErrorLevel Recover() {
+      Release_SDA();
+      for (unsigned char pulse = 0; pulse < 9 && !SDA_High(); ++pulse) {
+        Pull_SCL_Low();
+        USI_TWI_RECOVERY_HALF_PERIOD.wait();
+        if (!Release_SCL()) {
+          return USI_TWI_BUS_STUCK;
+        }
+        USI_TWI_RECOVERY_HALF_PERIOD.wait();
+      }
+      if (!SDA_High()) {
+        return USI_TWI_BUS_STUCK;
+      }
+
+      /* Generate Stop Condition */
+      Pull_SCL_Low();
+      Pull_SDA_Low();
+      USI_TWI_RECOVERY_HALF_PERIOD.wait();
+      if (!Release_SCL()) {
+        return USI_TWI_BUS_STUCK;
+      }
+      USI_TWI_RECOVERY_HALF_PERIOD.wait();
+      Release_SDA();
+      USI_TWI_RECOVERY_HALF_PERIOD.wait();
+      return USI_TWI_NO_SCL_HI;
+    }
+
+    // Clock one bit, with SCL low before and after: put it on SDA (a 1 by releasing SDA,
+    // also to let the slave drive it) and sample SDA while SCL is high.
+    template <typename Device>
+    static USI_TWI_ErrorLevel Clock(bool bit, bool& sampled) {
+      if (bit) {
+        Release_SDA();
+      } else {
+        Pull_SDA_Low();
+      }
+      Device::tPRE_SCL_HIGH.wait();
+      if (!Release_SCL()) {
+        return Recover();
+      }
+      sampled = SDA_High();
+      Device::tPOST_SCL_HIGH.wait();
+      Pull_SCL_Low();
+      return USI_TWI_OK;
+    }
+
+    // Also a repeated START, e.g. after receiveWhenReady, which needs both lines high
+    // for a while before SDA falls (tSU;STA, as long as tHD;STA in the specification).
+    template <typename Device>
+    static USI_TWI_ErrorLevel Start() {
+      Release_SDA();
+      if (!Release_SCL()) {
+        return Recover();
+      }
+      Device::tHSTART.wait();
+      if (!SDA_High()) {
+        return USI_TWI_MISSING_START_CON; // someone holds SDA low
+      }
+      Pull_SDA_Low();
+      Device::tHSTART.wait();
+      Pull_SCL_Low();
+      return USI_TWI_OK;
+    }
+
+    template <typename Device>
+    static USI_TWI_ErrorLevel Transmit(unsigned char const msg, bool const isAddress) {
+      for (USI_TWI_Int<unsigned char> mask = 0x80; mask != 0; mask >>= 1) {
+        bool const bit = (mask & msg) != 0;
+        bool sampled = false;
+        auto err = Clock<Device>(bit, sampled);
+        if (err) return err;
+        if (bit && !sampled) return USI_TWI_UE_DATA_COL;
+      }
+      Device::tPOST_TRANSFER.wait();
+
+      /* Clock and verify (N)ACK from slave */
+      bool nack = false;
+      auto err = Clock<Device>(true, nack);
+      if (err) return err;
+      Device::tPOST_TRANSFER.wait();
+      if (nack) {
+        return isAddress ? USI_TWI_NO_ACK_ON_ADDRESS : USI_TWI_NO_ACK_ON_DATA;
+      }
+      return USI_TWI_OK;
+    }
+
+    template <typename Device>
+    static USI_TWI_ErrorLevel Read_Bytes(unsigned char* buf, unsigned char len) {
+      while (len > 0) {
+        --len;
+        USI_TWI_Int<unsigned char> received = 0;
+        for (USI_TWI_Int<unsigned char> i = 0; i < 8; ++i) {
+          bool sampled = false;
+          auto err = Clock<Device>(true, sampled);
+          if (err) return err;
+          received <<= 1;
+          received |= sampled;
+        }
+        Device::tPOST_TRANSFER.wait();
+        *(buf++) = received;
+
+        bool ignored = false;
+        auto err = Clock<Device>(len == 0, ignored); // NACK the last byte, ACK the others.
+        if (err) return err;
+        Device::tPOST_TRANSFER.wait();
+      }
+      return USI_TWI_OK;
+    }
+
+    template <typename Device>
+    static USI_TWI_ErrorLevel Stop_Condition() {
+      Pull_SDA_Low();
+      if (!Release_SCL()) {
+        return Recover();
+      }
+      Device::tSSTOP.wait();
+      Release_SDA();
+      Device::tIDLE.wait();
+      if (!SDA_High()) {
+        return USI_TWI_MISSING_STOP_CON;
+      }
+      return USI_TWI_OK;
+    }
+
+  public:
+    // Release both lines, without pull-ups of our own.
+    static void Initialise() {
+      PORT_USI &= ~(1 << SDA | 1 << SCL);
+      DDR_USI &= ~(1 << SDA | 1 << SCL);
+    }
+
+    template <typename Device>
+    static USI_TWI_ErrorLevel Start_Sending() {
+      USI_TWI_Trace_Start(Device::ADDRESS);
+      auto err = Start<Device>();
+      if (!err) err = Transmit<Device>(USI_TWI_Prefix(USI_TWI_SEND, Device::ADDRESS), true);
+      if (err) USI_TWI_Trace_End(err);
+      return err;
+    }
+
+    template <typename Device>
+    static USI_TWI_ErrorLevel Start_Receiving() {
+      USI_TWI_Trace_Start(Device::ADDRESS);
+      auto err = Start<Device>();
+      if (!err) err = Transmit<Device>(USI_TWI_Prefix(USI_TWI_RCVE, Device::ADDRESS), true);
+      if (err) USI_TWI_Trace_End(err);
+      return err;
+    }
+
+    template <typename Device>
+    static USI_TWI_ErrorLevel Send(unsigned char msg) {
+      auto err = Transmit<Device>(msg, false);
+      if (err) {
+        USI_TWI_Trace_End(err);
+      } else {
+        USI_TWI_Trace_Bytes(1);
+      }
+      return err;
+    }
+
+    template <typename Device, typename Source>
+    static USI_TWI_ErrorLevel Send_Burst(Source source, unsigned int const count, unsigned int& sent) {
+      auto err = USI_TWI_OK;
+      for (sent = 0; sent < count; ++sent) {
+        err = Transmit<Device>(source.next(), false);
+        if (err) break;
+      }
+      USI_TWI_Trace_Bytes(sent);
+      if (err) USI_TWI_Trace_End(err);
+      return err;
+    }
+
+    template <typename Device>
+    static USI_TWI_ErrorLevel Read(unsigned char* buf, unsigned char len) {
+      auto err = Read_Bytes<Device>(buf, len);
+      if (err) {
+        USI_TWI_Trace_End(err);
+      } else {
+        USI_TWI_Trace_Bytes(len);
+      }
+      return err;
+    }
+
+    template <typename Device>
+    static USI_TWI_ErrorLevel Receive(unsigned char* buf, unsigned char len) {
+      auto err = Start_Receiving<Device>();
+      if (err) return err;
+      err = Read<Device>(buf, len);
+      if (err) return err;
+      return Stop<Device>();
+    }
+
+    template <typename Device>
+    static USI_TWI_ErrorLevel Stop() {
+      auto err = Stop_Condition<Device>();
+      USI_TWI_Trace_End(err);
+      return err;
+    }
+
+    // Stop() returns once the transaction ended, and reports how it went.
+    static bool Pending() {
+      return false;
+    }
+
+    static USI_TWI_ErrorLevel Result() {
+      return USI_TWI_OK;
+    }
+};
@@ -0,0 +1,28 @@
+#pragma once
+#include <Arduino.h>
+
+// Compile-time list of devices of the same kind, e.g. several sensors, each with
+// its own address and timing. Code that picks a device by index at runtime still
+// runs the instance specialized for that device, so constant delays stay free.
+template <typename First, typename... Rest>
+struct DeviceList {
+  static constexpr uint8_t COUNT = 1 + sizeof...(Rest);
+
+  // Call Action<Device>::run(args...) for the device at index, comparing it with
+  // each device's in turn, rather than through a table that AVR would keep in RAM.
+  template <template <typename> class Action, typename... Args>
+  static auto apply(uint8_t index, Args&&... args) -> decltype(Action<First>::run(args...)) {
+    return index == 0 ? Action<First>::run(args...)
+                      : DeviceList<Rest...>::template apply<Action>(uint8_t(index - 1), args...);
+  }
+};
+
+template <typename Last>
+struct DeviceList<Last> {
+  static constexpr uint8_t COUNT = 1;
+
+  template <template <typename> class Action, typename... Args>
+  static auto apply(uint8_t, Args&&... args) -> decltype(Action<Last>::run(args...)) {
+    return Action<Last>::run(args...);
+  }
+};
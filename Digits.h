@@ -0,0 +1,101 @@
+#pragma once
+#include <Arduino.h>
+
+// Digits of an unsigned number, found without division, which the ATtiny85
+// has to do in software: in radix 16 by shifting, in radix 10 by subtracting
+// each power of ten as often as it goes, from the most significant digit down.
+// That takes fewer cycles than libgcc's division, or double dabble, for every
+// number the formatters send (host/digits_benchmark.cpp counts them). Byte is
+// there for the benchmark, to count what the digits cost.
+template <uint8_t RADIX, uint8_t DIGITS, typename Byte = byte>
+class Digits {
+    static_assert(RADIX == 10 || RADIX == 16, "only decimal and hexadecimal digits");
+    static_assert(RADIX == 16 || DIGITS <= 9, "powers of ten up to 32 bits");
+    static constexpr uint8_t BYTES = (DIGITS + 1) / 2;
+
+    Byte packed[BYTES]; // two digits per byte, least significant first
+    bool fitting;
+
+    template <uint8_t I> struct Place {};
+
+    static constexpr uint32_t power(uint8_t i) {
+      return i ? 10 * power(i - 1) : 1;
+    }
+
+    // Largest value of U, or of 32 bits, U being possibly host::Cycles rather than an integer.
+    template <typename U>
+    static constexpr uint32_t largest() {
+      return sizeof(U) < 4 ? (uint32_t(1) << 8 * sizeof(U)) - 1 : ~uint32_t(0);
+    }
+
+    // 10^i as a U, or the largest U if it's more.
+    template <typename U>
+    static constexpr U power_at_most(uint8_t i) {
+      return U(power(i) < largest<U>() ? power(i) : largest<U>());
+    }
+
+    // Subtract 10^I from number as often as it goes, and so on for each lower digit.
+    template <typename U, uint8_t I>
+    void subtract(U number, Place<I>) {
+      if (power(I) <= largest<U>()) {
+        Byte digit = 0;
+        while (number >= power_at_most<U>(I)) {
+          number -= power_at_most<U>(I);
+          digit += 1;
+        }
+        packed[I / 2] |= digit << (I % 2 * 4);
+      }
+      subtract(number, Place < I - 1 > {});
+    }
+
+    template <typename U>
+    void subtract(U number, Place<0>) {
+      packed[0] |= Byte(number);
+    }
+
+  public:
+    template <typename U>
+    explicit Digits(U number) {
+      static_assert(U(~U{0}) > U{0}, "only unsigned numbers");
+      for (Byte& b : packed) {
+        b = 0;
+      }
+      if (RADIX == 16) {
+        for (uint8_t i = 0; i < DIGITS; ++i) {
+          packed[i / 2] |= Byte(number & 0xF) << (i % 2 * 4);
+          number >>= 4;
+        }
+        fitting = number == 0;
+        return;
+      }
+
+      fitting = power(DIGITS) > largest<U>() || number < power_at_most<U>(DIGITS);
+      if (fitting) {
+        subtract(number, Place < DIGITS - 1 > {});
+      }
+    }
+
+    // Whether all digits of the number are here.
+    bool fits() const {
+      return fitting;
+    }
+
+    // The ith least significant digit.
+    uint8_t operator[](uint8_t i) const {
+      return packed[i / 2] >> (i % 2 * 4) & 0xF;
+    }
+
+    // Write the digits as characters, from the first significant one or at least
+    // the last MINIMUM, and return where the text ends (not terminated).
+    char* text(char* out, uint8_t minimum = 1) const {
+      bool significant = false;
+      for (uint8_t i = DIGITS; i-- > 0;) {
+        uint8_t const digit = (*this)[i];
+        significant |= digit != 0 || i < minimum;
+        if (significant) {
+          *out++ = char(digit < 10 ? '0' + digit : 'A' - 10 + digit);
+        }
+      }
+      return out;
+    }
+};
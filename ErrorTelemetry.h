@@ -0,0 +1,184 @@
+#pragma once
+#include <avr/eeprom.h>
+#include "I2C.h"
+
+// Counts of communication errors per device, error level and location bucket, kept
+// across resets. Counting only touches RAM. Once enough errors were counted, or
+// some time passed since the first, the counts are copied to the next of SLOTS
+// copies in EEPROM, one byte per call of maintain(), so that neither the caller
+// waits for EEPROM nor any byte of EEPROM wears out SLOTS times faster than needed.
+// The table holds the ENTRIES most frequent kinds of error, most frequent first;
+// kinds that don't fit in are only counted as others. Takes 18 + 10 * ENTRIES bytes
+// of RAM, half of which for the copy being written.
+template <uint8_t ENTRIES, uint8_t SLOTS>
+class ErrorTelemetry {
+  public:
+    static constexpr uint8_t BUCKET_SHIFT = 3;  // locations per bucket, as power of 2
+    static constexpr uint8_t BATCH = 8;         // errors that make a copy to EEPROM due
+    static constexpr unsigned long PERIOD = 60000; // ms after an error that make a copy due
+    // Bytes of EEPROM per copy: sequence number, others, entries and checksum.
+    static constexpr unsigned int SLOT_BYTES = 2 + 2 + ENTRIES * 5 + 1;
+    static constexpr unsigned int EEPROM_BYTES = SLOTS * SLOT_BYTES;
+    static_assert(SLOT_BYTES <= 0xFF, "counting bytes of a copy in a byte");
+    // Seeds the checksum of each copy, and changes whenever the layout of copies would.
+    static constexpr uint8_t MARKER = 0xE1;
+
+    struct Entry {
+      uint8_t address;  // of the device
+      uint8_t error;    // USI_TWI_ErrorLevel
+      uint8_t bucket;   // location >> BUCKET_SHIFT
+      uint16_t count;   // 0 if the entry is unused
+    };
+
+  private:
+    unsigned int const eeprom_address;
+    Entry entries[ENTRIES];
+    uint16_t others;
+    uint16_t sequence;       // of the latest copy in EEPROM
+    uint8_t slot;            // of the latest copy in EEPROM
+    uint8_t pending;         // errors counted since the latest copy, up to BATCH
+    unsigned long first_pending; // ms timestamp
+    uint8_t image[SLOT_BYTES];   // copy being written
+    uint8_t written;         // bytes of image written, SLOT_BYTES if none is being written
+
+    uint8_t* stored(uint8_t s) const {
+      return reinterpret_cast<uint8_t*>(eeprom_address + s * SLOT_BYTES);
+    }
+
+    static uint8_t checksum(uint8_t const* bytes) {
+      uint8_t sum = MARKER;
+      for (unsigned int i = 0; i < SLOT_BYTES - 1; ++i) {
+        sum = uint8_t((sum << 1 | sum >> 7) ^ bytes[i]);
+      }
+      return sum;
+    }
+
+    static uint16_t word(uint8_t const* bytes) {
+      return uint16_t(bytes[0] | bytes[1] << 8);
+    }
+
+    static void put_word(uint8_t* bytes, uint16_t w) {
+      bytes[0] = uint8_t(w);
+      bytes[1] = uint8_t(w >> 8);
+    }
+
+    // Take a snapshot of the counts to write as the next copy.
+    void start_copy() {
+      ++sequence;
+      if (++slot == SLOTS) slot = 0;
+      put_word(image, sequence);
+      put_word(image + 2, others);
+      uint8_t* p = image + 4;
+      for (Entry const& e : entries) {
+        *p++ = e.address;
+        *p++ = e.error;
+        *p++ = e.bucket;
+        put_word(p, e.count);
+        p += 2;
+      }
+      *p = checksum(image);
+      written = 0;
+      pending = 0;
+    }
+
+  public:
+    // Keeps its copies in EEPROM_BYTES of EEPROM at eeprom_address.
+    explicit ErrorTelemetry(unsigned int eeprom_address)
+      : eeprom_address(eeprom_address)
+      , entries{}
+      , others(0)
+      , sequence(0)
+      , slot(SLOTS - 1)
+      , pending(0)
+      , first_pending(0)
+      , written(SLOT_BYTES) {
+    }
+
+    // Restore the counts from the latest valid copy in EEPROM, if any.
+    void load() {
+      bool found = false;
+      for (uint8_t s = 0; s < SLOTS; ++s) {
+        eeprom_read_block(image, stored(s), SLOT_BYTES);
+        if (image[SLOT_BYTES - 1] != checksum(image)) continue;
+        uint16_t const seq = word(image);
+        if (found && int16_t(seq - sequence) <= 0) continue;
+        found = true;
+        sequence = seq;
+        slot = s;
+        others = word(image + 2);
+        uint8_t const* p = image + 4;
+        for (Entry& e : entries) {
+          e.address = p[0];
+          e.error = p[1];
+          e.bucket = p[2];
+          e.count = word(p + 3);
+          p += 5;
+        }
+      }
+    }
+
+    // Count an error reported by a conversation with the device at address.
+    void count(uint8_t address, I2C::Status status, unsigned long now) {
+      if (!status.error) return;
+      uint8_t const bucket = status.location >> BUCKET_SHIFT;
+      uint8_t i = 0;
+      while (i < ENTRIES && entries[i].count != 0
+             && !(entries[i].address == address && entries[i].error == status.error && entries[i].bucket == bucket)) {
+        ++i;
+      }
+      if (i == ENTRIES) {
+        if (others != 0xFFFF) ++others;
+      } else {
+        Entry& e = entries[i];
+        if (e.count == 0) {
+          e.address = address;
+          e.error = status.error;
+          e.bucket = bucket;
+        }
+        if (e.count != 0xFFFF) ++e.count;
+        // Keep the most frequent first.
+        for (; i > 0 && entries[i - 1].count < entries[i].count; --i) {
+          Entry const swapped = entries[i - 1];
+          entries[i - 1] = entries[i];
+          entries[i] = swapped;
+        }
+      }
+      if (pending == 0) first_pending = now;
+      if (pending != BATCH) ++pending;
+    }
+
+    // Continue writing the copy to EEPROM, or start one if due. Returns quickly:
+    // it only writes a byte if EEPROM is done writing the previous one.
+    void maintain(unsigned long now) {
+      if (written == SLOT_BYTES) {
+        if (pending == 0 || (pending < BATCH && now - first_pending < PERIOD)) return;
+        start_copy();
+      }
+      if (eeprom_is_ready()) {
+        eeprom_update_byte(stored(slot) + written, image[written]);
+        ++written;
+      }
+    }
+
+    // Write all counted to EEPROM before returning, e.g. before giving up:
+    // the copy being written, if any, and another one if counted since it began.
+    void flush() {
+      for (;;) {
+        while (written != SLOT_BYTES) {
+          eeprom_update_byte(stored(slot) + written, image[written]);
+          ++written;
+        }
+        if (pending == 0) return;
+        start_copy();
+      }
+    }
+
+    // The kinds of error counted, most frequent first; stop at the first with count 0.
+    Entry const& operator[](uint8_t i) const {
+      return entries[i];
+    }
+
+    uint16_t other_errors() const {
+      return others;
+    }
+};
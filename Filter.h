@@ -0,0 +1,135 @@
+#pragma once
+#include <Arduino.h>
+
+/*****************************************************************************
+  Filtering of unsigned samples, e.g. micrometers measured, without floating
+  point or division: a median of the last few samples against outliers,
+  smoothing of the medians against jitter, and hysteresis to tell whether
+  the result moved enough to be worth displaying.
+****************************************************************************/
+
+// The samples as they're stored and compared. Host benchmarks built with
+// FILTER_COUNTED have host::Cycles count the work on them.
+#if FILTER_COUNTED
+#include "AvrCycles.h"
+using FilterSample = host::Cycles<uint32_t>;
+#else
+using FilterSample = uint32_t;
+#endif
+
+// Median of the last N samples, with N odd. Costs 4 bytes of RAM per sample, plus 1.
+template <uint8_t N>
+class MedianFilter {
+    static_assert(N % 2 == 1, "median of an odd number of samples");
+    FilterSample ring[N];
+    uint8_t next; // index in ring of the oldest sample
+
+  public:
+    MedianFilter() : ring{}, next(0) {}
+
+    // Start over as if the last N samples were all this one.
+    void reset(uint32_t sample) {
+      for (FilterSample& r : ring) {
+        r = sample;
+      }
+      next = 0;
+    }
+
+    uint32_t add(uint32_t sample) {
+      ring[next] = sample;
+      if (++next == N) next = 0;
+      FilterSample sorted[N];
+      for (uint8_t i = 0; i < N; ++i) {
+        FilterSample const r = ring[i];
+        uint8_t j = i;
+        for (; j > 0 && sorted[j - 1] > r; --j) {
+          sorted[j] = sorted[j - 1];
+        }
+        sorted[j] = r;
+      }
+      return sorted[N / 2];
+    }
+};
+
+// Exponential moving average, each sample weighing 1 / 2^SHIFT, in 4 bytes of RAM.
+// The average is kept with SHIFT bits of fraction, so samples must fit in 32 - SHIFT bits.
+template <uint8_t SHIFT>
+class SmoothingFilter {
+    static_assert(SHIFT <= 8, "samples of 24 bits must fit");
+    FilterSample scaled; // average << SHIFT
+
+  public:
+    SmoothingFilter() : scaled(0) {}
+
+    void reset(uint32_t sample) {
+      scaled = sample << SHIFT;
+    }
+
+    uint32_t add(uint32_t sample) {
+      scaled += FilterSample(sample) - (scaled >> SHIFT);
+      return scaled >> SHIFT;
+    }
+};
+
+// Holds on to a value until one comes along that differs at least THRESHOLD, in 4 bytes of RAM.
+template <uint32_t THRESHOLD>
+class Hysteresis {
+    FilterSample held;
+
+  public:
+    Hysteresis() : held(0) {}
+
+    void reset(uint32_t value) {
+      held = value;
+    }
+
+    // Tell whether value replaced the one held.
+    bool update(FilterSample value) {
+      if (value >= held + THRESHOLD || value + THRESHOLD <= held) {
+        held = value;
+        return true;
+      }
+      return false;
+    }
+
+    uint32_t value() const {
+      return held;
+    }
+};
+
+// The three stages in a row, in 5 bytes of RAM on top of theirs.
+template <uint8_t MEDIAN, uint8_t SHIFT, uint32_t THRESHOLD>
+class SampleFilter {
+    MedianFilter<MEDIAN> median;
+    SmoothingFilter<SHIFT> smoothing;
+    Hysteresis<THRESHOLD> hysteresis;
+    FilterSample latest; // smoothed value
+    bool primed;         // got a sample before
+
+  public:
+    SampleFilter() : latest(0), primed(false) {}
+
+    // Take a sample, and tell whether the filtered value changed.
+    bool add(uint32_t sample) {
+      if (!primed) {
+        primed = true;
+        median.reset(sample);
+        smoothing.reset(sample);
+        hysteresis.reset(sample);
+        latest = sample;
+        return true;
+      }
+      latest = smoothing.add(median.add(sample));
+      return hysteresis.update(latest);
+    }
+
+    // The filtered value, as it changed last.
+    uint32_t value() const {
+      return hysteresis.value();
+    }
+
+    // The filtered value as it moves, even within the threshold.
+    uint32_t smoothed() const {
+      return latest;
+    }
+};
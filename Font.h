@@ -0,0 +1,158 @@
+#pragma once
+#include "Glyph.h"
+
+// What a proportional font is made of: the characters it has, and for each the
+// ascii art of its glyph, 8 columns wide like a Glyph, of which the blank columns
+// on either side are trimmed. Art nullptr stands for a glyph without pixels, like a space.
+struct FontArt {
+  char const* chars;
+  char const* const* art; // one per character
+  uint8_t count;          // of characters
+  uint8_t blank_width;    // of glyphs without pixels
+};
+
+// Compiles a FontArt into columns of display food, so that both labels laid out
+// at compile time and fonts stored in program memory are rendered the same way.
+namespace FontCompiler {
+
+// Columns between glyphs, unless kerning takes it away.
+static constexpr uint8_t SPACING = 1;
+
+static constexpr byte segAt(char const* art, uint8_t x) {
+  return GlyphExtractor::extractSegAt(art, 0, 1, x, Glyph::SEGS);
+}
+
+// First column of art with pixels, or SEGS if none.
+static constexpr uint8_t firstColumn(char const* art, uint8_t x = 0) {
+  return x == Glyph::SEGS || segAt(art, x) ? x : firstColumn(art, x + 1);
+}
+
+// Column after the last one of art with pixels, or 0 if none.
+static constexpr uint8_t endColumn(char const* art, uint8_t x = Glyph::SEGS) {
+  return x == 0 || segAt(art, x - 1) ? x : endColumn(art, x - 1);
+}
+
+static constexpr bool blank(FontArt const& font, uint8_t glyph) {
+  return !font.art[glyph] || firstColumn(font.art[glyph]) == Glyph::SEGS;
+}
+
+static constexpr uint8_t width(FontArt const& font, uint8_t glyph) {
+  return blank(font, glyph) ? font.blank_width : endColumn(font.art[glyph]) - firstColumn(font.art[glyph]);
+}
+
+static constexpr byte columnAt(FontArt const& font, uint8_t glyph, uint8_t x) {
+  return blank(font, glyph) ? 0 : segAt(font.art[glyph], firstColumn(font.art[glyph]) + x);
+}
+
+// Where the columns of a glyph start, with all glyphs packed together.
+static constexpr uint16_t offset(FontArt const& font, uint8_t glyph) {
+  return glyph == 0 ? 0 : offset(font, glyph - 1) + width(font, glyph - 1);
+}
+
+// Index of the glyph of a character, or count if the font doesn't have it.
+static constexpr uint8_t index(FontArt const& font, char c, uint8_t glyph = 0) {
+  return glyph == font.count || font.chars[glyph] == c ? glyph : index(font, c, glyph + 1);
+}
+
+// Column x of all glyphs packed together, searching from glyph onwards.
+static constexpr byte packedAt(FontArt const& font, uint16_t x, uint8_t glyph = 0) {
+  return x < width(font, glyph) ? columnAt(font, glyph, x) : packedAt(font, x - width(font, glyph), glyph + 1);
+}
+
+// Kerning: leave out the spacing between two glyphs if the facing columns,
+// the last one of the left glyph and the first of the right one,
+// wouldn't touch, not even diagonally.
+static constexpr uint8_t gap(byte left_column, byte right_column) {
+  return (left_column | left_column << 1 | left_column >> 1) & right_column ? SPACING : 0;
+}
+
+// Columns before a glyph, after the one of previous (or none if previous is count).
+static constexpr uint8_t gapBefore(FontArt const& font, uint8_t previous, uint8_t glyph) {
+  return previous == font.count ? 0 : gap(columnAt(font, previous, width(font, previous) - 1), columnAt(font, glyph, 0));
+}
+
+// Columns taken by text after the glyph previous, skipping characters the font doesn't have.
+static constexpr uint16_t textWidth(FontArt const& font, char const* text, uint8_t previous) {
+  return !*text ? 0
+         : index(font, *text) == font.count ? textWidth(font, text + 1, previous)
+         : gapBefore(font, previous, index(font, *text)) + width(font, index(font, *text))
+         + textWidth(font, text + 1, index(font, *text));
+}
+
+static constexpr byte textColumn(FontArt const& font, char const* text, uint16_t x, uint8_t previous);
+
+// Column x of text, whose first character has glyph, preceded by lead blank columns.
+static constexpr byte glyphColumn(FontArt const& font, char const* text, uint16_t x, uint8_t glyph, uint8_t lead) {
+  return x < lead ? 0
+         : x - lead < width(font, glyph) ? columnAt(font, glyph, uint8_t(x - lead))
+         : textColumn(font, text + 1, x - lead - width(font, glyph), glyph);
+}
+
+// Column x of text after the glyph previous.
+static constexpr byte textColumn(FontArt const& font, char const* text, uint16_t x, uint8_t previous) {
+  return !*text ? 0
+         : index(font, *text) == font.count ? textColumn(font, text + 1, x, previous)
+         : glyphColumn(font, text, x, index(font, *text), gapBefore(font, previous, index(font, *text)));
+}
+
+}
+
+// Number of columns of all glyphs of a font packed together.
+static constexpr uint16_t font_columns(FontArt const& font) {
+  return FontCompiler::offset(font, font.count);
+}
+
+// Proportional font in program memory, in a single blob: the characters, the offset
+// of each glyph's columns (the next offset telling its width), and all columns
+// trimmed and packed together. Declare it like QuarterLabel, e.g.
+//   static constexpr FontArt ART = { "0123456789", GlyphArt::DEC_DIGITS, 10, 4 };
+//   static Font<10, font_columns(ART)> PROGMEM const FONT { ART };
+template <uint8_t GLYPHS, uint16_t COLUMNS>
+class Font {
+    static_assert(COLUMNS <= 0xFF, "offsets fit in a byte");
+
+  public:
+    static constexpr uint8_t NONE = GLYPHS;
+
+    constexpr Font(FontArt const& art)
+      : Font(art,
+             typename GlyphExtractor::MakeIndices<GLYPHS>::type{},
+             typename GlyphExtractor::MakeIndices<GLYPHS + 1>::type{},
+             typename GlyphExtractor::MakeIndices<COLUMNS>::type{}) {
+    }
+
+    // Index of the glyph of a character, or NONE if the font doesn't have it.
+    uint8_t glyph(char c) const {
+      uint8_t i = 0;
+      while (i < GLYPHS && char(pgm_read_byte(&chars[i])) != c) {
+        ++i;
+      }
+      return i;
+    }
+
+    uint8_t width(uint8_t glyph) const {
+      return pgm_read_byte(&offsets[glyph + 1]) - pgm_read_byte(&offsets[glyph]);
+    }
+
+    // Program memory address of the columns of a glyph.
+    byte const* bytes(uint8_t glyph) const {
+      return columns + pgm_read_byte(&offsets[glyph]);
+    }
+
+    // Columns to leave between two glyphs, after kerning.
+    uint8_t gap(uint8_t left, uint8_t right) const {
+      return FontCompiler::gap(pgm_read_byte(bytes(left) + width(left) - 1), pgm_read_byte(bytes(right)));
+    }
+
+  private:
+    char const chars[GLYPHS];
+    byte const offsets[GLYPHS + 1];
+    byte const columns[COLUMNS];
+
+    template <size_t... G, size_t... O, size_t... C>
+    constexpr Font(FontArt const& art, GlyphExtractor::Indices<G...>, GlyphExtractor::Indices<O...>, GlyphExtractor::Indices<C...>)
+      : chars{art.chars[G]...}
+      , offsets{byte(FontCompiler::offset(art, O))...}
+      , columns{FontCompiler::packedAt(art, C)...} {
+    }
+};
@@ -1,157 +1,25 @@
 #include "Glyph.h"
 
 Glyph PROGMEM const Glyph::dec_digit[] = {
-  {
-    " ###### "
-    "##    ##"
-    "##    ##"
-    "##    ##"
-    "##    ##"
-    "##    ##"
-    "##    ##"
-    " ###### "
-  }, {
-    "    ### "
-    "   #### "
-    "  ## ## "
-    " ##  ## "
-    "     ## "
-    "     ## "
-    "     ## "
-    "     ## "
-  }, {
-    " ###### "
-    "##    ##"
-    "      ##"
-    "     ## "
-    "    ##  "
-    "   ##   "
-    " ##     "
-    "########"
-  }, {
-    " ###### "
-    "##    ##"
-    "      ##"
-    "   #### "
-    "      ##"
-    "      ##"
-    "##    ##"
-    " ###### "
-  }, {
-    "   #### "
-    "  ## ## "
-    " ##  ## "
-    "##   ## "
-    "##   ## "
-    "########"
-    "     ## "
-    "     ## "
-  }, {
-    "########"
-    "##      "
-    "##      "
-    "####### "
-    "      ##"
-    "      ##"
-    "##    ##"
-    " ###### "
-  }, {
-    "  ##### "
-    " ##   ##"
-    "##      "
-    "# ##### "
-    "##    ##"
-    "##    ##"
-    "##    ##"
-    " ###### "
-  }, {
-    "########"
-    "      ##"
-    "     ## "
-    "    ##  "
-    "   ##   "
-    "   ##   "
-    "   ##   "
-    "   ##   "
-  }, {
-    " ###### "
-    "##    ##"
-    "##    ##"
-    " ###### "
-    "##    ##"
-    "##    ##"
-    "##    ##"
-    " ###### "
-  }, {
-    " ###### "
-    "##    ##"
-    "##    ##"
-    " ###### "
-    "      ##"
-    "      ##"
-    "##   ## "
-    " #####  "
-  }
+  GlyphArt::DEC_DIGITS[0], GlyphArt::DEC_DIGITS[1], GlyphArt::DEC_DIGITS[2], GlyphArt::DEC_DIGITS[3], GlyphArt::DEC_DIGITS[4],
+  GlyphArt::DEC_DIGITS[5], GlyphArt::DEC_DIGITS[6], GlyphArt::DEC_DIGITS[7], GlyphArt::DEC_DIGITS[8], GlyphArt::DEC_DIGITS[9]
 };
 
 Glyph PROGMEM const Glyph::ABCDEF[] = {
-  {
-    " ###### "
-    "##    ##"
-    "##    ##"
-    "########"
-    "##    ##"
-    "##    ##"
-    "##    ##"
-    "##    ##"
-  }, {
-    "####### "
-    "##    ##"
-    "##    ##"
-    "####### "
-    "##    ##"
-    "##    ##"
-    "##    ##"
-    "####### "
-  }, {
-    " ###### "
-    "##    ##"
-    "##      "
-    "##      "
-    "##      "
-    "##      "
-    "##    ##"
-    " ###### "
-  }, {
-    "######  "
-    "##   ## "
-    "##    ##"
-    "##    ##"
-    "##    ##"
-    "##    ##"
-    "##   ## "
-    "######  "
-  }, {
-    "########"
-    "##      "
-    "##      "
-    "######  "
-    "##      "
-    "##      "
-    "##      "
-    "########"
-  }, {
-    "########"
-    "##      "
-    "##      "
-    "######  "
-    "##      "
-    "##      "
-    "##      "
-    "##      "
-  }
+  GlyphArt::ABCDEF[0], GlyphArt::ABCDEF[1], GlyphArt::ABCDEF[2], GlyphArt::ABCDEF[3], GlyphArt::ABCDEF[4], GlyphArt::ABCDEF[5]
 };
 
+#if GLYPH_PRESPLIT
+QuarterGlyph PROGMEM const QuarterGlyph::dec_digit[] = {
+  GlyphArt::DEC_DIGITS[0], GlyphArt::DEC_DIGITS[1], GlyphArt::DEC_DIGITS[2], GlyphArt::DEC_DIGITS[3], GlyphArt::DEC_DIGITS[4],
+  GlyphArt::DEC_DIGITS[5], GlyphArt::DEC_DIGITS[6], GlyphArt::DEC_DIGITS[7], GlyphArt::DEC_DIGITS[8], GlyphArt::DEC_DIGITS[9]
+};
+
+QuarterGlyph PROGMEM const QuarterGlyph::ABCDEF[] = {
+  GlyphArt::ABCDEF[0], GlyphArt::ABCDEF[1], GlyphArt::ABCDEF[2], GlyphArt::ABCDEF[3], GlyphArt::ABCDEF[4], GlyphArt::ABCDEF[5]
+};
+#endif
+
 Glyph PROGMEM const Glyph::X = {
   "#      #"
   " #    # "
@@ -163,16 +31,7 @@ Glyph PROGMEM const Glyph::X = {
   "#      #"
 };
 
-Glyph PROGMEM const Glyph::at = {
-  "  ####  "
-  " #    # "
-  "#  ##  #"
-  "# #  # #"
-  "# #  # #"
-  "#  #### "
-  " #      "
-  "  ##### "
-};
+Glyph PROGMEM const Glyph::at = { GlyphArt::AT };
 
 Glyph PROGMEM const Glyph::plus = {
   "        "
@@ -196,27 +55,9 @@ GlyphPair PROGMEM const GlyphPair::cm = {
   " ###   #   #   #"
 };
 
-GlyphPair PROGMEM const GlyphPair::m = {
-  "                "
-  "                "
-  "   # ### ##     "
-  "   ##  ##  #    "
-  "   #   #   #    "
-  "   #   #   #    "
-  "   #   #   #    "
-  "   #   #   #    "
-};
+GlyphPair PROGMEM const GlyphPair::m = { GlyphArt::M };
 
-GlyphPair PROGMEM const GlyphPair::err = {
-  "                "
-  "                "
-  " ###   # ## # ##"
-  "#   #  ##   ##  "
-  "#####  #    #   "
-  "#      #    #   "
-  "#   #  #    #   "
-  " ###   #    #   "
-};
+GlyphPair PROGMEM const GlyphPair::err = { GlyphArt::ERR };
 
 GlyphPair PROGMEM const GlyphPair::pin = {
   "###   #         "
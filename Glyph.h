@@ -1,6 +1,27 @@
 #pragma once
 #include <Arduino.h>
+#include <stddef.h>
 
+// Whether to also store digits pre-split over the two pages of an OLED quarter
+// (see QuarterGlyph), doubling their flash size to save work for each column,
+// and to send each digit in one burst (host/glyph_benchmark.cpp measures both).
+// Change it here rather than in the sketch, so that Glyph.cpp agrees.
+#ifndef GLYPH_PRESPLIT
+#define GLYPH_PRESPLIT 0
+#endif
+
+// The integers of glyph columns as they're looked up and split over pages, and
+// of the digits of numbers sent. Host benchmarks built with GLYPH_COUNTED have
+// host::Cycles count the work on them.
+#if GLYPH_COUNTED
+#include "AvrCycles.h"
+template <typename T>
+using GlyphInt = host::Cycles<T>;
+#else
+template <typename T>
+using GlyphInt = T;
+#endif
+using GlyphByte = GlyphInt<byte>;
 
 namespace GlyphExtractor {
 
@@ -22,11 +43,261 @@ static constexpr byte extractSegAt(const char* art, int glyph_index, int glyph_c
          | pixel(art[x + segs_per_glyph * (glyph_index + glyph_count * 7)]) << 7;
 }
 
+// Extract display food for one column of one glyph centered on two pages: the byte for the upper or the lower page.
+static constexpr byte extractHalfSegAt(const char* art, int glyph_index, int glyph_count, int x, int segs_per_glyph, int page) {
+  return page == 0
+         ? byte(extractSegAt(art, glyph_index, glyph_count, x, segs_per_glyph) << 4)
+         : byte(extractSegAt(art, glyph_index, glyph_count, x, segs_per_glyph) >> 4);
+}
+
 // Convert ascii art representing a column to display food.
 static constexpr byte extractSeg(const char* column) {
   return extractSegAt(column, 0, 1, 0, 1);
 }
 
+// Sequence 0, 1, ..., N-1 for initializing arrays in constexpr constructors.
+template <size_t... I> struct Indices {};
+template <size_t N, size_t... I> struct MakeIndices : MakeIndices < N - 1, N - 1, I... > {};
+template <size_t... I> struct MakeIndices<0, I...> {
+  using type = Indices<I...>;
+};
+
+}
+
+// Ascii art of glyphs that are also laid out in labels (see QuarterLabel)
+// or compiled into proportional fonts (see Font).
+namespace GlyphArt {
+
+static constexpr char const* const DEC_DIGITS[] = {
+  {
+    " ###### "
+    "##    ##"
+    "##    ##"
+    "##    ##"
+    "##    ##"
+    "##    ##"
+    "##    ##"
+    " ###### "
+  }, {
+    "    ### "
+    "   #### "
+    "  ## ## "
+    " ##  ## "
+    "     ## "
+    "     ## "
+    "     ## "
+    "     ## "
+  }, {
+    " ###### "
+    "##    ##"
+    "      ##"
+    "     ## "
+    "    ##  "
+    "   ##   "
+    " ##     "
+    "########"
+  }, {
+    " ###### "
+    "##    ##"
+    "      ##"
+    "   #### "
+    "      ##"
+    "      ##"
+    "##    ##"
+    " ###### "
+  }, {
+    "   #### "
+    "  ## ## "
+    " ##  ## "
+    "##   ## "
+    "##   ## "
+    "########"
+    "     ## "
+    "     ## "
+  }, {
+    "########"
+    "##      "
+    "##      "
+    "####### "
+    "      ##"
+    "      ##"
+    "##    ##"
+    " ###### "
+  }, {
+    "  ##### "
+    " ##   ##"
+    "##      "
+    "# ##### "
+    "##    ##"
+    "##    ##"
+    "##    ##"
+    " ###### "
+  }, {
+    "########"
+    "      ##"
+    "     ## "
+    "    ##  "
+    "   ##   "
+    "   ##   "
+    "   ##   "
+    "   ##   "
+  }, {
+    " ###### "
+    "##    ##"
+    "##    ##"
+    " ###### "
+    "##    ##"
+    "##    ##"
+    "##    ##"
+    " ###### "
+  }, {
+    " ###### "
+    "##    ##"
+    "##    ##"
+    " ###### "
+    "      ##"
+    "      ##"
+    "##   ## "
+    " #####  "
+  }
+};
+
+static constexpr char const* const ABCDEF[] = {
+  {
+    " ###### "
+    "##    ##"
+    "##    ##"
+    "########"
+    "##    ##"
+    "##    ##"
+    "##    ##"
+    "##    ##"
+  }, {
+    "####### "
+    "##    ##"
+    "##    ##"
+    "####### "
+    "##    ##"
+    "##    ##"
+    "##    ##"
+    "####### "
+  }, {
+    " ###### "
+    "##    ##"
+    "##      "
+    "##      "
+    "##      "
+    "##      "
+    "##    ##"
+    " ###### "
+  }, {
+    "######  "
+    "##   ## "
+    "##    ##"
+    "##    ##"
+    "##    ##"
+    "##    ##"
+    "##   ## "
+    "######  "
+  }, {
+    "########"
+    "##      "
+    "##      "
+    "######  "
+    "##      "
+    "##      "
+    "##      "
+    "########"
+  }, {
+    "########"
+    "##      "
+    "##      "
+    "######  "
+    "##      "
+    "##      "
+    "##      "
+    "##      "
+  }
+};
+
+static constexpr char const* const POINT = {
+  "        "
+  "        "
+  "        "
+  "        "
+  "        "
+  "        "
+  "##      "
+  "##      "
+};
+
+static constexpr char const* const LOWER_E = {
+  "        "
+  "        "
+  " ###    "
+  "#   #   "
+  "#####   "
+  "#       "
+  "#   #   "
+  " ###    "
+};
+
+static constexpr char const* const LOWER_M = {
+  "        "
+  "        "
+  "# ## #  "
+  "##  # # "
+  "#   #  #"
+  "#   #  #"
+  "#   #  #"
+  "#   #  #"
+};
+
+static constexpr char const* const LOWER_R = {
+  "        "
+  "        "
+  "# ##    "
+  "##      "
+  "#       "
+  "#       "
+  "#       "
+  "#       "
+};
+
+static constexpr char const* const AT = {
+  "  ####  "
+  " #    # "
+  "#  ##  #"
+  "# #  # #"
+  "# #  # #"
+  "#  #### "
+  " #      "
+  "  ##### "
+};
+
+// Pairs of glyphs, with rows of 16 columns.
+static constexpr char const* const M = {
+  "                "
+  "                "
+  "   # ### ##     "
+  "   ##  ##  #    "
+  "   #   #   #    "
+  "   #   #   #    "
+  "   #   #   #    "
+  "   #   #   #    "
+};
+
+static constexpr char const* const ERR = {
+  "                "
+  "                "
+  " ###   # ## # ##"
+  "#   #  ##   ##  "
+  "#####  #    #   "
+  "#      #    #   "
+  "#   #  #    #   "
+  " ###   #    #   "
+};
+
 }
 
 class Glyph {
@@ -85,7 +356,7 @@ class Glyph {
     {}
 
   public:
-    byte seg(uint8_t x) const {
+    GlyphByte seg(uint8_t x) const {
       switch (x) {
         case 0: return pgm_read_byte(&seg0);
         case 1: return pgm_read_byte(&seg1);
@@ -100,6 +371,56 @@ class Glyph {
     }
 };
 
+// Glyph already split over the two pages of an OLED quarter, two bytes per column,
+// in the order that they are sent in vertical addressing mode.
+class QuarterGlyph {
+  public:
+    static uint8_t constexpr BYTES = 2 * Glyph::SEGS;
+
+    static QuarterGlyph PROGMEM const dec_digit[10];
+    static QuarterGlyph PROGMEM const ABCDEF[6];
+
+    static QuarterGlyph const& hex_digit_hi(uint8_t n) {
+      return hex_digit(n >> 4);
+    }
+
+    static QuarterGlyph const& hex_digit_lo(uint8_t n) {
+      return hex_digit(n & 0xF);
+    }
+
+    // Program memory address of the display food.
+    byte const* bytes() const {
+      return food;
+    }
+
+  private:
+    static QuarterGlyph const& hex_digit(uint8_t n) {
+      return n < 10 ? dec_digit[n] : ABCDEF[n - 10];
+    }
+
+    static constexpr byte split(const char* art, int i) {
+      return GlyphExtractor::extractHalfSegAt(art, 0, 1, i / 2, Glyph::SEGS, i % 2);
+    }
+
+    byte const food[BYTES];
+
+    // Construct display food from ascii art.
+    // Private to keep all instances in this class and as PROGMEM.
+    constexpr QuarterGlyph(const char* art)
+      : food{split(art, 0), split(art, 1), split(art, 2), split(art, 3),
+             split(art, 4), split(art, 5), split(art, 6), split(art, 7),
+             split(art, 8), split(art, 9), split(art, 10), split(art, 11),
+             split(art, 12), split(art, 13), split(art, 14), split(art, 15)}
+    {}
+};
+
+// The glyphs that the digit formatters send.
+#if GLYPH_PRESPLIT
+using DigitGlyph = QuarterGlyph;
+#else
+using DigitGlyph = Glyph;
+#endif
+
 class GlyphPair {
   public:
     static uint8_t constexpr WIDTH = 2 * Glyph::SEGS;
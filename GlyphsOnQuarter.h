@@ -1,134 +1,484 @@
 #pragma once
+#include "Digits.h"
 #include "Glyph.h"
 #include "OLED.h"
+#include "QuarterLabel.h"
 
-template <typename Device>
-class GlyphsOnQuarter : public OLED::QuarterChat<Device> {
-    using super = OLED::QuarterChat<Device>;
-  private:
-    static constexpr byte HEARTBEAT_SEG1 = GlyphExtractor::extractSeg("  # # # ");
-    static constexpr byte HEARTBEAT_SEG2 = GlyphExtractor::extractSeg("# # #   ");
+// What was last sent to one cell of a field, i.e. by one call of GlyphsOnPages::send.
+struct GlyphCell {
+  uintptr_t key; // address of the glyph, or GlyphCell::RUN | column
+  uint8_t xEnd;  // column after the cell, or 0 if unknown
 
-    // Should be OLED::Quarter, but that cannot be narrowed until gcc 9.3.
-    // Should be const, but AutoFormat screws up.
-    uint8_t quarter_bit : 4;
-    bool include_heartbeat : 1;
+  static constexpr uintptr_t RUN = ~uintptr_t{0xFF}; // never the address of a glyph
+};
 
-    bool toggle_heartbeat() {
-      if (include_heartbeat) {
-        include_heartbeat = false;
-        static uint8_t heartbeat_per_quarter = 0b0000;
-        heartbeat_per_quarter ^= quarter_bit;
-        return heartbeat_per_quarter & quarter_bit;
-      } else {
-        return false;
+// Remembers what is on display in a field, so that GlyphsOnPages can skip unchanged cells.
+// Costs 3 bytes of RAM per cell. Invalidate it whenever something else draws over the field.
+template <uint8_t CELLS>
+class GlyphCache {
+    template <typename Device, uint8_t PAGES, uint8_t SCALE> friend class GlyphsOnPages;
+    GlyphCell cells[CELLS];
+
+  public:
+    GlyphCache() {
+      invalidate();
+    }
+
+    void invalidate() {
+      for (GlyphCell& cell : cells) {
+        cell.xEnd = 0;
       }
     }
+};
+
+// Stretches a column of a glyph, 8 pixels high, SCALE times, into SCALE bytes,
+// each looked up in a table by the 8 / SCALE pixels of the glyph it covers.
+template <uint8_t SCALE>
+class ColumnScaler {
+    static_assert(SCALE == 2 || SCALE == 4 || SCALE == 8, "scale by a power of two");
+    static constexpr uint8_t BITS = 8 / SCALE; // pixels of the glyph per byte
+
+    static constexpr byte stretch(uint8_t bits, uint8_t i = 0) {
+      return i == BITS ? 0 : (bits >> i & 1 ? byte(((1 << SCALE) - 1) << (i * SCALE)) : 0) | stretch(bits, i + 1);
+    }
+
+    struct Table {
+      byte entries[1 << BITS];
+
+      template <size_t... I>
+      constexpr Table(GlyphExtractor::Indices<I...>) : entries{stretch(I)...} {}
+    };
+
+    static Table PROGMEM const table;
+
+  public:
+    // The ith byte of the stretched column, from the top.
+    static GlyphByte part(GlyphByte seg, uint8_t i) {
+      return pgm_read_byte(&table.entries[seg >> (BITS * i) & ((1 << BITS) - 1)]);
+    }
+};
+
+template <uint8_t SCALE>
+typename ColumnScaler<SCALE>::Table PROGMEM const ColumnScaler<SCALE>::table {
+  typename GlyphExtractor::MakeIndices<1 << BITS>::type{}
+};
 
+template <>
+class ColumnScaler<1> {
   public:
-    // start_location is merely the initial value of a counter for error reporting.
-    explicit GlyphsOnQuarter(uint8_t start_location,
-                             OLED::Quarter quarter, uint8_t xBegin = 0, uint8_t xEnd = OLED::WIDTH - 1,
-                             bool include_heartbeat = true)
-      : super(start_location, quarter, xBegin, xEnd)
-      , quarter_bit(uint8_t(1 << static_cast<uint8_t>(quarter)))
-      , include_heartbeat(include_heartbeat) {
+    static GlyphByte part(GlyphByte seg, uint8_t) {
+      return seg;
     }
+};
 
-    GlyphsOnQuarter& send(byte seg, uint8_t times = 1) {
-      for (uint8_t x = 0; x < times; ++x) {
-        if (toggle_heartbeat()) {
-          super::send(seg << 4 | HEARTBEAT_SEG1,
-                      seg >> 4 | HEARTBEAT_SEG2);
-        } else {
-          super::send(seg << 4,
-                      seg >> 4);
-        }
-      }
-      return *this;
+// What one call of GlyphsOnPages::send draws in a cell: columns of glyphs,
+// to be drawn as large as the field draws them. Recorded by GlyphLine.
+struct GlyphLineCell {
+  enum Kind : uint8_t {
+    RUN,   // columns all the same, the lowest byte of key
+    GLYPH, // a Glyph at key, with margins
+    SPLIT, // display food at key split for a quarter, like QuarterGlyph, with margins
+    SEGS   // a byte per column at key in program memory, like a glyph of a Font
+  };
+
+  uintptr_t key;      // as in GlyphCell
+  uint8_t width;      // in columns of the glyphs, including margins
+  uint8_t margin : 4; // blank columns on either side of the glyph
+  uint8_t kind : 4;
+};
+
+// The formatting functions of GlyphsOnPages and GlyphLine, which Derived carries
+// out in its sendCell, one cell per call.
+template <typename Derived, uint8_t SCALE>
+class GlyphFormatter {
+    Derived& sendCell(uintptr_t key, uint8_t width, uint8_t margin, GlyphLineCell::Kind kind) {
+      Derived& derived = static_cast<Derived&>(*this);
+      derived.sendCell(GlyphLineCell{key, width, margin, kind});
+      return derived;
+    }
+
+  public:
+    Derived& send(byte seg, uint8_t times = 1) {
+      return sendCell(GlyphCell::RUN | seg, times, 0, GlyphLineCell::RUN);
+    }
+
+    Derived& send(Glyph const& glyph, uint8_t margin = 0) {
+      return sendCell(uintptr_t(&glyph), margin + Glyph::SEGS + margin, margin, GlyphLineCell::GLYPH);
+    }
+
+    // Send a glyph split for a quarter in one burst, or if drawing anything else,
+    // put its columns back together first.
+    Derived& send(QuarterGlyph const& glyph, uint8_t margin = 0) {
+      return sendCell(uintptr_t(glyph.bytes()), margin + Glyph::SEGS + margin, margin, GlyphLineCell::SPLIT);
     }
 
-    GlyphsOnQuarter& send(Glyph const& glyph, uint8_t margin = 0) {
-      send(0, margin);
-      for (uint8_t x = 0; x < Glyph::SEGS; ++x) {
-        send(glyph.seg(x));
+    // Send a label laid out at compile time, in one burst from program memory,
+    // or like a QuarterGlyph if not drawing in a quarter.
+    template <uint8_t COLUMNS>
+    Derived& send(QuarterLabel<COLUMNS> const& label) {
+      return sendCell(uintptr_t(label.bytes()), COLUMNS, 0, GlyphLineCell::SPLIT);
+    }
+
+    // Send text in a proportional font, each glyph and each gap between glyphs
+    // a cell of its own, skipping characters the font doesn't have.
+    template <uint8_t GLYPHS, uint16_t COLUMNS>
+    Derived& send(Font<GLYPHS, COLUMNS> const& font, char const* text) {
+      uint8_t previous = font.NONE;
+      for (; *text; ++text) {
+        uint8_t const glyph = font.glyph(*text);
+        if (glyph == font.NONE) continue;
+        if (previous != font.NONE) {
+          uint8_t const gap = font.gap(previous, glyph);
+          if (gap) send(0, gap);
+        }
+        sendCell(uintptr_t(font.bytes(glyph)), font.width(glyph), 0, GlyphLineCell::SEGS);
+        previous = glyph;
       }
-      send(0, margin);
-      return *this;
+      return static_cast<Derived&>(*this);
     }
 
-    GlyphsOnQuarter& sendColon() {
+    Derived& sendColon() {
       send(0, Glyph::DIGIT_MARGIN);
       send(Glyph::COLON_SEG, Glyph::POINT_WIDTH - 2 * Glyph::DIGIT_MARGIN);
-      send(0, Glyph::DIGIT_MARGIN);
-      return *this;
+      return send(0, Glyph::DIGIT_MARGIN);
     }
 
-    GlyphsOnQuarter& sendPoint() {
+    Derived& sendPoint() {
       send(0, Glyph::DIGIT_MARGIN);
       send(Glyph::POINT_SEG, Glyph::POINT_WIDTH - 2 * Glyph::DIGIT_MARGIN);
-      send(0, Glyph::DIGIT_MARGIN);
-      return *this;
+      return send(0, Glyph::DIGIT_MARGIN);
     }
 
-    GlyphsOnQuarter& send2hex(uint8_t number) {
-      send(Glyph::hex_digit_hi(number), Glyph::DIGIT_MARGIN);
-      send(Glyph::hex_digit_lo(number), Glyph::DIGIT_MARGIN);
-      return *this;
+    // Number of columns of the display that sendNumber<RADIX, WIDTH, POINT> sends.
+    static constexpr uint8_t numberWidth(uint8_t width, uint8_t point = 0) {
+      return (Glyph::DIGIT_WIDTH * width + (point ? Glyph::POINT_WIDTH : 0)) * SCALE;
     }
 
-    GlyphsOnQuarter& send4hex(uint16_t number) {
-      send(Glyph::hex_digit_hi(uint8_t(number >> 8)), Glyph::DIGIT_MARGIN);
-      send(Glyph::hex_digit_lo(uint8_t(number >> 8)), Glyph::DIGIT_MARGIN);
-      send(Glyph::hex_digit_hi(uint8_t(number >> 0)), Glyph::DIGIT_MARGIN);
-      send(Glyph::hex_digit_lo(uint8_t(number >> 0)), Glyph::DIGIT_MARGIN);
-      return *this;
+    // Number of cells that sendNumber<RADIX, WIDTH, POINT> sends at most.
+    static constexpr uint8_t numberCells(uint8_t width, uint8_t point = 0) {
+      return width + (point ? 3 : 0);
     }
 
-    GlyphsOnQuarter& send3dec(uint8_t number) {
-      uint8_t p1 = number / 100;
-      uint8_t p2 = number % 100;
-      if (p1 != 0) {
-        send(Glyph::dec_digit[p1], Glyph:: DIGIT_MARGIN);
-      } else {
-        send(0, Glyph::DIGIT_WIDTH);
+    // Send the digits of an unsigned number in WIDTH digit cells, leaving out the
+    // DROPPED least significant digits, with a decimal point before the last POINT
+    // digits, and blanks instead of zeros before the first significant digit
+    // (unless LEADING_ZEROS). If the number doesn't fit, all cells light up.
+    template <uint8_t RADIX, uint8_t WIDTH, uint8_t POINT = 0, bool LEADING_ZEROS = false, uint8_t DROPPED = 0, typename U>
+    Derived& sendNumber(U number) {
+      static_assert(POINT < WIDTH, "need a digit before the point");
+      Digits<RADIX, DROPPED + WIDTH, GlyphByte> const digits {GlyphInt<U>(number)};
+      if (!digits.fits()) {
+        return send(~0, numberWidth(WIDTH, POINT) / SCALE);
       }
-      if (p1 != 0 || p2 >= 10) {
-        send(Glyph::dec_digit[p2 / 10], Glyph::DIGIT_MARGIN);
-      } else {
-        send(0, Glyph::DIGIT_WIDTH);
+      bool significant = LEADING_ZEROS;
+      for (uint8_t i = WIDTH; i-- > 0;) {
+        uint8_t const digit = digits[DROPPED + i];
+        significant |= digit != 0 || i <= POINT;
+        if (!significant) {
+          send(0, Glyph::DIGIT_WIDTH);
+        } else if (RADIX == 10) {
+          send(DigitGlyph::dec_digit[digit], Glyph::DIGIT_MARGIN);
+        } else {
+          send(DigitGlyph::hex_digit_lo(digit), Glyph::DIGIT_MARGIN);
+        }
+        if (POINT && i == POINT) {
+          sendPoint();
+        }
       }
-      send(Glyph::dec_digit[p2 % 10], Glyph::DIGIT_MARGIN);
-      return *this;
+      return static_cast<Derived&>(*this);
     }
 
-    GlyphsOnQuarter& send4dec(int number) {
+    Derived& send2hex(uint8_t number) {
+      return sendNumber<16, 2, 0, true>(number);
+    }
+
+    Derived& send4hex(uint16_t number) {
+      return sendNumber<16, 4, 0, true>(number);
+    }
+
+    Derived& send3dec(uint8_t number) {
+      return sendNumber<10, 3>(number);
+    }
+
+    Derived& send4dec(int number) {
       if (number < 0) {
-        send(Glyph::MINUS_SEG, Glyph::DIGIT_WIDTH * 4);
-        return *this;
-      }
-      uint8_t p1 = number / 100;
-      uint8_t p2 = number % 100;
-      if (p1 >= 100) {
-        send(~0, Glyph::DIGIT_WIDTH * 4);
-        return *this;
+        return send(Glyph::MINUS_SEG, Glyph::DIGIT_WIDTH * 4);
       }
-      if (p1 >= 10) {
-        send(Glyph::dec_digit[p1 / 10], Glyph::DIGIT_MARGIN);
+      return sendNumber<10, 4>(unsigned(number));
+    }
+};
+
+// A line of glyphs formatted once, to be drawn SCALE times as large by GlyphsOnPages
+// on several displays, each skipping the cells its own cache remembers, without
+// finding digits and glyphs again. Keeps up to CELLS cells, at 4 bytes of RAM each;
+// the last one lights up if more were sent, like a number that doesn't fit.
+template <uint8_t CELLS, uint8_t SCALE = 1>
+class GlyphLine : public GlyphFormatter<GlyphLine<CELLS, SCALE>, SCALE> {
+    friend class GlyphFormatter<GlyphLine, SCALE>;
+    template <typename Device, uint8_t PAGES, uint8_t S> friend class GlyphsOnPages;
+    static_assert(CELLS > 0, "room for a cell");
+    GlyphLineCell cells[CELLS];
+    uint8_t count;
+
+    void sendCell(GlyphLineCell const& cell) {
+      if (count < CELLS) {
+        cells[count++] = cell;
       } else {
-        send(0, Glyph::DIGIT_WIDTH);
+        cells[CELLS - 1] = GlyphLineCell{GlyphCell::RUN | 0xFF, cells[CELLS - 1].width, 0, GlyphLineCell::RUN};
       }
-      if (p1 != 0) {
-        send(Glyph::dec_digit[p1 % 10], Glyph::DIGIT_MARGIN);
-      } else {
-        send(0, Glyph::DIGIT_WIDTH);
+    }
+
+  public:
+    static constexpr uint8_t CAPACITY = CELLS;
+
+    GlyphLine() : count(0) {}
+};
+
+// Draws glyphs SCALE times as large on PAGES consecutive pages, vertically centered,
+// i.e. on 2 pages at scale 1 shifted down half a page, as in a quarter of the display.
+// Widths, including margins and runs, are given in columns of the glyphs.
+// Every column of a glyph costs the same: SCALE table lookups, and SCALE times PAGES bytes.
+template <typename Device, uint8_t PAGES, uint8_t SCALE = 1>
+class GlyphsOnPages : public OLED::Chat<Device>, public GlyphFormatter<GlyphsOnPages<Device, PAGES, SCALE>, SCALE> {
+    using super = OLED::Chat<Device>;
+    using formatter = GlyphFormatter<GlyphsOnPages, SCALE>;
+    friend formatter;
+    static_assert(SCALE <= PAGES && PAGES <= OLED::HEIGHT / 8, "glyphs fit on the pages");
+
+  private:
+    static constexpr byte HEARTBEAT_SEG1 = GlyphExtractor::extractSeg("  # # # ");
+    static constexpr byte HEARTBEAT_SEG2 = GlyphExtractor::extractSeg("# # #   ");
+    static constexpr uint8_t TOP = (PAGES - SCALE) * 4;    // blank rows above the glyph
+    static constexpr uint8_t BLANK_PAGES = TOP / 8;        // blank pages above the glyph
+    static constexpr uint8_t SHIFT = TOP % 8;              // rows the glyph is shifted within pages
+    static constexpr uint8_t INKED_PAGES = SCALE + (SHIFT != 0);
+
+    GlyphCell* const cache;
+    uint8_t const cache_size;
+    uint8_t cell;
+    uint8_t x;
+    uint8_t const xEnd;
+    // Should be const, but AutoFormat screws up.
+    uint8_t heartbeat_bit : 4;
+    uint8_t first_page : 3;
+    OLED::Heartbeat heartbeat_column : 2; // until it's drawn
+    bool aligned : 1;     // all cells so far ended where they did last time
+    bool window_open : 1; // the display expects data for column x
+    bool sent_data : 1;   // the display expects nothing but data until restarted
+
+    bool toggle_heartbeat() {
+      OLED::Heartbeat const heartbeat = PAGES >= 2 ? heartbeat_column : OLED::Heartbeat::None;
+      heartbeat_column = OLED::Heartbeat::None;
+      switch (heartbeat) {
+        case OLED::Heartbeat::Toggled: {
+          static uint8_t heartbeat_per_quarter = 0b0000;
+          heartbeat_per_quarter ^= heartbeat_bit;
+          return heartbeat_per_quarter & heartbeat_bit;
+        }
+        case OLED::Heartbeat::On:
+          return true;
+        default:
+          return false;
       }
-      if (p1 != 0 || p2 >= 10) {
-        send(Glyph::dec_digit[p2 / 10], Glyph::DIGIT_MARGIN);
+    }
+
+    void open_window(uint8_t xBegin) {
+      if (sent_data) {
+        super::restart();
       } else {
-        send(0, Glyph::DIGIT_WIDTH);
+        super::set_page_address(first_page, first_page + PAGES - 1);
+      }
+      super::set_column_address(xBegin, xEnd).start_data();
+      window_open = true;
+      sent_data = true;
+    }
+
+    // Move on to the next cell, and tell whether it's already on display.
+    bool skip(uintptr_t key, uint8_t width) {
+      uint8_t const xBegin = x;
+      x += width;
+      if (cell < cache_size) {
+        GlyphCell& cached = cache[cell++];
+        if (aligned && cached.xEnd == x && cached.key == key) {
+          window_open = false;
+          return true;
+        }
+        aligned = cached.xEnd == x;
+        cached.key = key;
+        cached.xEnd = x;
+      }
+      if (!window_open) {
+        open_window(xBegin);
+      }
+      return false;
+    }
+
+    // Send one column of a quarter, already split over its two pages.
+    void sendColumn(GlyphByte b1, GlyphByte b2) {
+      if (toggle_heartbeat()) {
+        b1 |= HEARTBEAT_SEG1;
+        b2 |= HEARTBEAT_SEG2;
+      }
+      super::send(b1);
+      super::send(b2);
+    }
+
+    // Send one column of a glyph, SCALE times as wide and high.
+    void sendColumn(GlyphByte seg) {
+      GlyphByte column[PAGES];
+      GlyphByte carry = 0;
+      for (uint8_t page = 0; page < PAGES; ++page) {
+        uint8_t const part = page - BLANK_PAGES;
+        GlyphByte b = 0;
+        if (page >= BLANK_PAGES && part < INKED_PAGES) {
+          GlyphByte const stretched = part < SCALE ? ColumnScaler<SCALE>::part(seg, part) : GlyphByte(0);
+          b = GlyphByte(stretched << SHIFT) | carry;
+          carry = SHIFT ? GlyphByte(stretched >> (8 - SHIFT)) : GlyphByte(0);
+        }
+        column[page] = b;
+      }
+      for (uint8_t repeat = 0; repeat < SCALE; ++repeat) {
+        bool const heartbeat = repeat == 0 && toggle_heartbeat();
+        for (uint8_t page = 0; page < PAGES; ++page) {
+          GlyphByte b = column[page];
+          if (heartbeat && page == PAGES / 2 - 1) b |= HEARTBEAT_SEG1;
+          if (heartbeat && page == PAGES / 2) b |= HEARTBEAT_SEG2;
+          super::send(b);
+        }
+      }
+    }
+
+    void sendColumns(byte seg, uint8_t times) {
+      for (uint8_t i = 0; i < times; ++i) {
+        sendColumn(seg);
+      }
+    }
+
+    // Send a cell unless it's already on display.
+    void sendCell(GlyphLineCell const& what) {
+      if (skip(what.key, what.width * SCALE)) return;
+      switch (what.kind) {
+        case GlyphLineCell::RUN:
+          sendColumns(byte(what.key), what.width);
+          return;
+        case GlyphLineCell::GLYPH: {
+          Glyph const& glyph = *reinterpret_cast<Glyph const*>(what.key);
+          sendColumns(0, what.margin);
+          for (GlyphByte i = 0; i < Glyph::SEGS; ++i) {
+            sendColumn(glyph.seg(i));
+          }
+          sendColumns(0, what.margin);
+          return;
+        }
+        case GlyphLineCell::SPLIT: {
+          byte const* const food = reinterpret_cast<byte const*>(what.key);
+          uint16_t const bytes = 2 * (what.width - 2 * what.margin);
+          sendColumns(0, what.margin);
+          if (PAGES == 2 && SCALE == 1) {
+            sendColumn(pgm_read_byte(food), pgm_read_byte(food + 1));
+            super::sendBytes_P(food + 2, bytes - 2);
+          } else {
+            for (uint16_t i = 0; i < bytes; i += 2) {
+              sendColumn(pgm_read_byte(food + i) >> 4 | pgm_read_byte(food + i + 1) << 4);
+            }
+          }
+          sendColumns(0, what.margin);
+          return;
+        }
+        case GlyphLineCell::SEGS: {
+          byte const* const columns = reinterpret_cast<byte const*>(what.key);
+          for (uint8_t i = 0; i < what.width; ++i) {
+            sendColumn(pgm_read_byte(columns + i));
+          }
+          return;
+        }
+      }
+    }
+
+  public:
+    // start_location is merely the initial value of a counter for error reporting.
+    explicit GlyphsOnPages(uint8_t start_location,
+                           uint8_t first_page, uint8_t xBegin = 0, uint8_t xEnd = OLED::WIDTH - 1,
+                           OLED::Heartbeat heartbeat = OLED::Heartbeat::Toggled)
+      : super(start_location)
+      , cache(nullptr)
+      , cache_size(0)
+      , cell(0)
+      , x(xBegin)
+      , xEnd(xEnd)
+      , heartbeat_bit(uint8_t(1 << first_page / 2))
+      , first_page(first_page)
+      , heartbeat_column(heartbeat)
+      , aligned(true)
+      , window_open(false)
+      , sent_data(false) {
+      open_window(xBegin);
+    }
+
+    // Only send cells that differ from what the cache remembers, each group of
+    // consecutive changed cells in its own window after a repeated start.
+    // The heartbeat, if included, gets a column of its own at xBegin, so the cells start after it.
+    template <uint8_t CELLS>
+    explicit GlyphsOnPages(uint8_t start_location,
+                           uint8_t first_page, GlyphCache<CELLS>& cache,
+                           uint8_t xBegin = 0, uint8_t xEnd = OLED::WIDTH - 1,
+                           OLED::Heartbeat heartbeat = OLED::Heartbeat::Toggled)
+      : super(start_location)
+      , cache(cache.cells)
+      , cache_size(CELLS)
+      , cell(0)
+      , x(xBegin)
+      , xEnd(xEnd)
+      , heartbeat_bit(uint8_t(1 << first_page / 2))
+      , first_page(first_page)
+      , heartbeat_column(heartbeat)
+      , aligned(true)
+      , window_open(false)
+      , sent_data(false) {
+      if (heartbeat != OLED::Heartbeat::None) {
+        open_window(xBegin);
+        sendColumn(0);
+        x += SCALE;
+      }
+    }
+
+    using formatter::send;
+
+    // Send a line formatted once, cell by cell.
+    template <uint8_t CELLS>
+    GlyphsOnPages& send(GlyphLine<CELLS, SCALE> const& line) {
+      for (uint8_t i = 0; i < line.count; ++i) {
+        sendCell(line.cells[i]);
       }
-      send(Glyph::dec_digit[p2 % 10], Glyph::DIGIT_MARGIN);
       return *this;
     }
+
+    // Finish, and forget what the cache remembers if anything may not have arrived.
+    I2C::Status stop() {
+      auto const status = super::stop();
+      for (uint8_t i = status.error ? 0 : cell; i < cache_size; ++i) {
+        cache[i].xEnd = 0;
+      }
+      return status;
+    }
+};
+
+// Draws glyphs in a quarter of the display, i.e. on its two pages.
+template <typename Device>
+class GlyphsOnQuarter : public GlyphsOnPages<Device, 2> {
+    using super = GlyphsOnPages<Device, 2>;
+  public:
+    explicit GlyphsOnQuarter(uint8_t start_location,
+                             OLED::Quarter quarter, uint8_t xBegin = 0, uint8_t xEnd = OLED::WIDTH - 1,
+                             OLED::Heartbeat heartbeat = OLED::Heartbeat::Toggled)
+      : super(start_location, static_cast<uint8_t>(quarter) * 2, xBegin, xEnd, heartbeat) {
+    }
+
+    template <uint8_t CELLS>
+    explicit GlyphsOnQuarter(uint8_t start_location,
+                             OLED::Quarter quarter, GlyphCache<CELLS>& cache,
+                             uint8_t xBegin = 0, uint8_t xEnd = OLED::WIDTH - 1,
+                             OLED::Heartbeat heartbeat = OLED::Heartbeat::Toggled)
+      : super(start_location, static_cast<uint8_t>(quarter) * 2, cache, xBegin, xEnd, heartbeat) {
+    }
 };
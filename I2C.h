@@ -11,17 +11,72 @@ struct Status {
   uint8_t location;
 };
 
-// Data conversation with an I2C device.
+template <typename>
+struct Void {
+  using type = void;
+};
+
+// The engine of the bus a device is on: Device::Bus if it names one, else the USI.
+template <typename Device, typename = void>
+struct BusOf {
+  using type = USI_TWI_Bus;
+};
+
 template <typename Device>
+struct BusOf<Device, typename Void<typename Device::Bus>::type> {
+  using type = typename Device::Bus;
+};
+
+// Collect a sample in a transaction of its own: start receiving, read len bytes and stop.
+template <typename Device, typename Bus = typename BusOf<Device>::type>
+USI_TWI_ErrorLevel receive(byte* buf, uint8_t len) {
+  return Bus::template Receive<Device>(buf, len);
+}
+
+// Whether transactions with the Device whose stop() returned are still going
+// on, which only happens on an engine that sends from interrupts.
+template <typename Device, typename Bus = typename BusOf<Device>::type>
+bool pending() {
+  return Bus::Pending();
+}
+
+// Wait for the transactions through the Device's bus to end, and report the
+// first error that turned up after their stop() returned, once.
+template <typename Device, typename Bus = typename BusOf<Device>::type>
+USI_TWI_ErrorLevel result() {
+  return Bus::Result();
+}
+
+// Data conversation with an I2C device, through the engine of its bus.
+template <typename Device, typename Bus = typename BusOf<Device>::type>
 class Chat {
   private:
     USI_TWI_ErrorLevel err;
     uint8_t location;
 
+    // Send count bytes as if one by one, but checking the bus state only once.
+    template <typename Source>
+    Chat& sendBurst(Source source, uint16_t count) {
+      if (!err && count != 0) {
+        unsigned int sent;
+        err = Bus::template Send_Burst<Device>(source, count, sent);
+        location += uint8_t(sent + (err != USI_TWI_OK));
+      }
+      return *this;
+    }
+
+    Chat& read(byte* buf, uint8_t len) {
+      if (!err) {
+        err = Bus::template Read<Device>(buf, len);
+        location += len;
+      }
+      return *this;
+    }
+
   public:
     // start_location is merely the initial value of a counter for error reporting.
     explicit Chat(uint8_t start_location) :
-      err{USI_TWI_Master_Start_Sending<Device>()},
+      err{Bus::template Start_Sending<Device>()},
       location{start_location} {
     }
 
@@ -34,23 +89,66 @@ class Chat {
     Chat& send(byte msg) {
       if (!err) {
         ++location;
-        err = USI_TWI_Master_Send<Device>(msg);
+        err = Bus::template Send<Device>(msg);
       }
       return *this;
     }
 
+    // Start over with a repeated start condition, without releasing the bus.
+    Chat& restart() {
+      if (!err) {
+        ++location;
+        err = Bus::template Start_Sending<Device>();
+      }
+      return *this;
+    }
+
+    // Read len bytes after a repeated start, without releasing the bus in between,
+    // e.g. after sending the register to read. This counts as one step plus one per
+    // byte read. Sending more afterwards requires a restart().
+    Chat& receive(byte* buf, uint8_t len) {
+      if (!err) {
+        ++location;
+        err = Bus::template Start_Receiving<Device>();
+      }
+      return read(buf, len);
+    }
+
+    // Like receive, but while the device doesn't acknowledge being read, e.g. because
+    // it's still measuring, try again up to attempts times, every interval_ms,
+    // still without releasing the bus.
+    Chat& receiveWhenReady(byte* buf, uint8_t len, uint8_t attempts, uint8_t interval_ms) {
+      if (!err) {
+        ++location;
+        for (;;) {
+          err = Bus::template Start_Receiving<Device>();
+          if (err != USI_TWI_NO_ACK_ON_ADDRESS || attempts == 0) break;
+          --attempts;
+          delay(interval_ms);
+        }
+      }
+      return read(buf, len);
+    }
+
     // Send the same byte many times.
     template <typename I>
     Chat& sendN(I count, byte msg) {
-      for (I i = 0; i < count; ++i) {
-        send(msg);
-      }
-      return *this;
+      return sendBurst(USI_TWI_Repeat_Source{msg}, count);
+    }
+
+    // Send bytes from RAM.
+    Chat& sendBytes(byte const* bytes, uint16_t count) {
+      return sendBurst(USI_TWI_Ram_Source{bytes}, count);
+    }
+
+    // Send bytes from program memory.
+    Chat& sendBytes_P(byte const* bytes, uint16_t count) {
+      return sendBurst(USI_TWI_Progmem_Source{bytes}, count);
     }
 
     Status stop() {
       if (!err) {
-        err = USI_TWI_Master_Stop<Device>();
+        err = Bus::template Stop<Device>();
       }
       return Status { err, location };
     }
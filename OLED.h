@@ -21,58 +21,124 @@ enum Addressing {
   PageAddressing = 0b10
 };
 
+enum ScrollDirection {
+  ScrollRight = 0,
+  ScrollLeft = 1
+};
+
 // Full conversation with SSD 1306.
+// Commands are batched in a command stream: a single PAYLOAD_LASTCOM followed
+// by any number of command bytes and options. Since the device doesn't take
+// data after that within the same transaction, start_data issues a repeated
+// start, costing one address byte instead of a control byte per command byte.
 template <typename Device>
 class Chat : public I2C::Chat<Device> {
     using super = I2C::Chat<Device>;
+    bool commanding = false; // in a command stream
+
+  protected:
+    // Send a command byte or option.
+    Chat& command(byte b) {
+      if (!commanding) {
+        commanding = true;
+        super::send(PAYLOAD_LASTCOM);
+      }
+      super::send(b);
+      return *this;
+    }
+
   public:
     explicit Chat(uint8_t start_location) : I2C::Chat<Device>(start_location) {}
 
     Chat& init() {
-      super::send(PAYLOAD_COMMAND).send(0x8D); // Set charge pump (powering the OLED grid)…
-      super::send(PAYLOAD_COMMAND).send(0x14); // …enabled.
+      command(0x8D); // Set charge pump (powering the OLED grid)…
+      command(0x14); // …enabled.
       return *this;
     }
 
     Chat& set_enabled(bool enabled = true) {
-      super::send(PAYLOAD_COMMAND).send(byte{0xAE} | byte{enabled});
-      return *this;
+      return command(byte{0xAE} | byte{enabled});
     }
 
     Chat& set_contrast(uint8_t fraction) {
-      super::send(PAYLOAD_COMMAND).send(0x81);
-      super::send(PAYLOAD_COMMAND).send(fraction);
-      return *this;
+      return command(0x81).command(fraction);
     }
 
     Chat& set_addressing_mode(Addressing mode) {
-      super::send(PAYLOAD_COMMAND).send(0x20);
-      super::send(PAYLOAD_COMMAND).send(mode);
-      return *this;
+      return command(0x20).command(mode);
     }
 
     Chat& set_column_address(uint8_t start = 0, uint8_t end = WIDTH - 1) {
-      super::send(PAYLOAD_COMMAND).send(0x21);
-      super::send(PAYLOAD_COMMAND).send(start);
-      super::send(PAYLOAD_COMMAND).send(end);
-      return *this;
+      return command(0x21).command(start).command(end);
     }
 
     Chat& set_page_address(uint8_t start = 0, uint8_t end = 7) {
-      super::send(PAYLOAD_COMMAND).send(0x22);
-      super::send(PAYLOAD_COMMAND).send(start);
-      super::send(PAYLOAD_COMMAND).send(end);
-      return *this;
+      return command(0x22).command(start).command(end);
     }
 
     Chat& set_page_start_address(uint8_t pageN) {
       set_addressing_mode(PageAddressing);
-      super::send(PAYLOAD_COMMAND).send(byte{0xB0} | pageN);
+      return command(byte{0xB0} | pageN);
+    }
+
+    // Display only the first rows of RAM (counted from the start line).
+    Chat& set_multiplex(uint8_t rows = HEIGHT) {
+      return command(0xA8).command(rows - 1);
+    }
+
+    // How the COM pins reach the lines of the panel: alternately from either side, as on
+    // 128x64 modules (the power-on setting), which also puts the rows of a lower multiplex
+    // ratio in order at the top, or in sequence, and either side first if remapped.
+    Chat& set_com_pins(bool alternative = true, bool remapped = false) {
+      return command(0xDA).command(byte{0x02} | byte{alternative} << 4 | byte{remapped} << 5);
+    }
+
+    // Display RAM from row line onwards at the top of the panel.
+    Chat& set_start_line(uint8_t line) {
+      return command(byte{0x40} | line);
+    }
+
+    Chat& set_display_offset(uint8_t rows) {
+      return command(0xD3).command(rows);
+    }
+
+    // Set up continuous scrolling of pages start to end, one column every
+    // so many frames, as encoded in interval: 0b111 for 2 up to 0b011 for 256.
+    // Takes effect with set_scrolling, after which RAM should not be written.
+    Chat& set_horizontal_scroll(ScrollDirection direction, uint8_t start, uint8_t end, uint8_t interval = 0b111) {
+      return command(0x26 + direction).command(0).command(start).command(interval).command(end)
+             .command(0x00).command(0xFF);
+    }
+
+    // Same, also scrolling all rows up by vertical_offset rows per step.
+    Chat& set_diagonal_scroll(ScrollDirection direction, uint8_t start, uint8_t end, uint8_t vertical_offset, uint8_t interval = 0b111) {
+      return command(0x29 + direction).command(0).command(start).command(interval).command(end)
+             .command(vertical_offset);
+    }
+
+    Chat& set_scrolling(bool enabled = true) {
+      return command(byte{0x2E} | byte{enabled});
+    }
+
+    // Move the RAM of pages start to end, columns xBegin to xEnd, by one column
+    // right away, wrapping the column pushed out to the other side.
+    Chat& scroll_content(ScrollDirection direction, uint8_t start, uint8_t end, uint8_t xBegin = 0, uint8_t xEnd = WIDTH - 1) {
+      return command(0x2C + direction).command(0).command(start).command(1).command(end)
+             .command(xBegin).command(xEnd);
+    }
+
+    // Start over with a repeated start condition, ready for commands or data.
+    Chat& restart() {
+      commanding = false;
+      super::restart();
       return *this;
     }
 
-    // You can only send the data and stop this chat after this.
+    // You can only send the data and stop this chat after this (or restart).
     I2C::Chat<Device>& start_data() {
+      if (commanding) {
+        restart();
+      }
       return super::send(PAYLOAD_DATA);
     }
 };
@@ -82,6 +148,60 @@ enum class Quarter : uint8_t {
   A, B, C, D
 };
 
+// Whether a field draws the heartbeat column, and how.
+enum class Heartbeat : uint8_t {
+  None,    // no heartbeat column
+  Toggled, // on for every other draw of the quarter
+  Off,     // as a DoubleBuffer tells, toggling with every flip
+  On
+};
+
+// Double buffering with half the display: the panel only shows 32 rows,
+// either quarters A and B of RAM or quarters C and D, depending on the start line.
+// Draw in the half that is hidden, then flip() to show it with a single command,
+// so that a half-finished update is never seen.
+class DoubleBuffer {
+    uint8_t shown; // half of RAM on display
+
+  public:
+    static constexpr uint8_t ROWS = HEIGHT / 2; // number of rows displayed, to set_multiplex
+
+    DoubleBuffer() : shown(0) {}
+
+    // Index (0 or 1) of the half of RAM on display.
+    uint8_t shown_half() const {
+      return shown;
+    }
+
+    // Index (0 or 1) of the half of RAM to draw in.
+    uint8_t hidden_half() const {
+      return shown ^ 1;
+    }
+
+    // Where quarter A or B of the panel lives in RAM when shown.
+    Quarter in_shown(Quarter quarter) const {
+      return Quarter(static_cast<uint8_t>(quarter) + shown * 2);
+    }
+
+    // Where quarter A or B of the panel lives in RAM next time it is shown.
+    Quarter in_hidden(Quarter quarter) const {
+      return Quarter(static_cast<uint8_t>(quarter) + hidden_half() * 2);
+    }
+
+    // The heartbeat to draw in the hidden half: the halves take turns to show
+    // it, so that it toggles with every flip, whatever is drawn in between.
+    Heartbeat heartbeat() const {
+      return hidden_half() ? Heartbeat::On : Heartbeat::Off;
+    }
+
+    // Show what was drawn in the hidden half.
+    template <typename Device>
+    I2C::Status flip(uint8_t start_location) {
+      shown ^= 1;
+      return Chat<Device>(start_location).set_start_line(shown * ROWS).stop();
+    }
+};
+
 // Data conversation with SSD 1306 addressing two consecutive pages.
 template <typename Device>
 class QuarterChat : public I2C::Chat<Device> {
@@ -0,0 +1,97 @@
+#pragma once
+#include <stddef.h>
+#include "Font.h"
+
+// A piece of the layout of a label: a glyph from ascii art with a margin on either
+// side, text in a proportional font, or a run of columns that are all the same, e.g. blank.
+struct LabelPiece {
+  char const* art;     // nullptr for text or a run
+  FontArt const* font; // nullptr for a glyph or a run
+  char const* chars;   // text in font
+  uint8_t glyph_index; // in art
+  uint8_t glyph_count; // in art
+  uint8_t margin;      // blank columns on either side of a glyph
+  byte seg;            // each column of a run
+  uint8_t width;       // in columns, including margins
+
+  static constexpr LabelPiece glyph(char const* art, uint8_t margin = 0, uint8_t glyph_index = 0, uint8_t glyph_count = 1) {
+    return LabelPiece{art, nullptr, nullptr, glyph_index, glyph_count, margin, 0, uint8_t(margin + Glyph::SEGS + margin)};
+  }
+
+  static constexpr LabelPiece run(byte seg, uint8_t width) {
+    return LabelPiece{nullptr, nullptr, nullptr, 0, 0, 0, seg, width};
+  }
+
+  static constexpr LabelPiece text(FontArt const& font, char const* text) {
+    return LabelPiece{nullptr, &font, text, 0, 0, 0, 0, uint8_t(FontCompiler::textWidth(font, text, font.count))};
+  }
+
+  static constexpr LabelPiece blank(uint8_t width) {
+    return run(0, width);
+  }
+
+  // Column x of this piece.
+  constexpr byte segAt(uint8_t x) const {
+    return font ? FontCompiler::textColumn(*font, chars, x, font->count)
+           : !art ? seg
+           : x < margin || x >= margin + Glyph::SEGS ? 0
+           : GlyphExtractor::extractSegAt(art, glyph_index, glyph_count, x - margin, Glyph::SEGS);
+  }
+};
+
+namespace LabelLayout {
+
+static constexpr uint16_t width(LabelPiece const* pieces, size_t count) {
+  return count == 0 ? 0 : pieces[0].width + width(pieces + 1, count - 1);
+}
+
+// Column x of a sequence of pieces.
+static constexpr byte segAt(LabelPiece const* pieces, size_t count, uint16_t x) {
+  return count == 0 ? 0
+         : x < pieces[0].width ? pieces[0].segAt(uint8_t(x))
+         : segAt(pieces + 1, count - 1, x - pieces[0].width);
+}
+
+}
+
+// Number of columns of the label laid out by pieces.
+template <size_t N>
+static constexpr uint16_t label_width(LabelPiece const (&pieces)[N]) {
+  return LabelLayout::width(pieces, N);
+}
+
+// Static text laid out at compile time into the column stream of an OLED quarter,
+// like QuarterGlyph: two bytes per column, to be sent in a single burst from PROGMEM.
+// Declare the layout as a constexpr array of pieces, e.g.
+//   static constexpr LabelPiece LAYOUT[] = { LabelPiece::blank(3), LabelPiece::glyph(GlyphArt::AT) };
+//   static QuarterLabel<label_width(LAYOUT)> PROGMEM const LABEL { LAYOUT };
+template <uint8_t COLUMNS>
+class QuarterLabel {
+  public:
+    static constexpr uint8_t WIDTH = COLUMNS;
+    static constexpr uint16_t BYTES = 2 * COLUMNS;
+
+    template <size_t N>
+    constexpr QuarterLabel(LabelPiece const (&pieces)[N])
+      : QuarterLabel(pieces, N, typename GlyphExtractor::MakeIndices<BYTES>::type{}) {
+    }
+
+    // Program memory address of the display food.
+    byte const* bytes() const {
+      return food;
+    }
+
+  private:
+    byte const food[BYTES];
+
+    template <size_t... I>
+    constexpr QuarterLabel(LabelPiece const* pieces, size_t count, GlyphExtractor::Indices<I...>)
+      : food{split(pieces, count, I)...} {
+    }
+
+    static constexpr byte split(LabelPiece const* pieces, size_t count, size_t i) {
+      return i % 2 == 0
+             ? byte(LabelLayout::segAt(pieces, count, uint16_t(i / 2)) << 4)
+             : byte(LabelLayout::segAt(pieces, count, uint16_t(i / 2)) >> 4);
+    }
+};
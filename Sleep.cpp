@@ -0,0 +1,77 @@
+#include "Sleep.h"
+#include <avr/interrupt.h>
+#include <avr/io.h>
+#include <avr/power.h>
+#include <avr/sleep.h>
+#include <avr/wdt.h>
+
+static unsigned long missed_ms;   // that Timer0 didn't count
+static unsigned int missed_us;    // and the microseconds beyond, less than 1000
+static volatile bool watched;     // the watchdog interrupt came
+
+ISR(WDT_vect) {
+  watched = true;
+}
+
+static void miss(unsigned long us) {
+  us += missed_us;
+  missed_ms += us / 1000;
+  missed_us = us % 1000;
+}
+
+unsigned long Sleep::millis() {
+  return ::millis() + missed_ms;
+}
+
+void Sleep::nap() {
+  set_sleep_mode(SLEEP_MODE_IDLE);
+  sleep_mode();
+}
+
+// Nap with the clock divided by 2^shift, so that Timer0 overflows within about 2^shift ms.
+static void nap_slow(uint8_t shift) {
+  unsigned long const start = micros();
+  clock_prescale_set(clock_div_t(shift));
+  Sleep::nap();
+  clock_prescale_set(clock_div_1);
+  miss((micros() - start) * ((1u << shift) - 1));
+}
+
+// Power down until the watchdog interrupt, after 16 ms * 2^period.
+static void power_down(uint8_t period) {
+  unsigned char const prescaler = (period & 8 ? 1 << WDP3 : 0) | (period & 7);
+  cli();
+  wdt_reset();
+  MCUSR &= ~(1 << WDRF);
+  WDTCR = (1 << WDCE) | (1 << WDE); // timed sequence: interrupt mode, without reset
+  WDTCR = (1 << WDIE) | prescaler;
+  watched = false;
+  set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+  sleep_enable();
+  while (!watched) {
+    sleep_bod_disable();
+    sei();
+    sleep_cpu();
+    cli();
+  }
+  sleep_disable();
+  WDTCR = (1 << WDCE) | (1 << WDE);
+  WDTCR = 0;
+  set_sleep_mode(SLEEP_MODE_IDLE); // for whoever naps with sleep_cpu() next
+  sei();
+  miss(16000ul << period);
+}
+
+void Sleep::at_most(unsigned long ms) {
+  if (ms >= 16) {
+    uint8_t period = 0;
+    while (period < 9 && (32ul << period) <= ms) ++period;
+    power_down(period);
+  } else if (ms >= 2) {
+    uint8_t shift = 1;
+    while ((2u << shift) <= ms) ++shift;
+    nap_slow(shift);
+  } else {
+    nap();
+  }
+}
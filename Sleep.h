@@ -0,0 +1,33 @@
+#pragma once
+#include <Arduino.h>
+
+/*****************************************************************************
+  Sleeping between events, drawing as little current as the time until the
+  next one allows:
+  - for 16 ms or more, in power-down, woken by the watchdog after the longest
+    of its periods, 16 ms times a power of 2, that fits;
+  - for less, in idle mode, with the clock prescaled as far as the wait allows
+    and restored to full speed on waking, before anything else runs, so that
+    the bus code and its delays only ever run at F_CPU;
+  - for a millisecond or less, in idle mode at full speed.
+  Timer0, which keeps millis(), runs slow on a prescaled clock and stops in
+  power-down. Sleep::millis() adds the time it missed: as measured by micros()
+  while prescaled, and the watchdog's nominal period in power-down, which is
+  only as accurate as its oscillator (within about 10%, by voltage and
+  temperature).
+****************************************************************************/
+
+namespace Sleep {
+
+// Milliseconds since boot, like millis(), including the time that Timer0 missed.
+unsigned long millis();
+
+// Sleep until the next interrupt, in idle mode at full speed: at most a
+// millisecond, when Timer0 overflows, or sooner, e.g. for the bus.
+void nap();
+
+// Sleep for up to ms milliseconds, as deep as that allows. Only when nothing
+// but Timer0 needs the clocks, e.g. no bus transaction runs from interrupts.
+void at_most(unsigned long ms);
+
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include <Arduino.h>
+
+namespace USDS {
+
+// More than the sensor measures (up to 4.5 m), so that only a reading gone wrong
+// says more, such as 0xFFFFFF when nothing drove SDA.
+static constexpr uint32_t MAX_MICROMETERS = 10000000;
+
+// How far apart two samples of a still scene may be, in micrometers.
+static constexpr uint32_t JITTER = 20000;
+
+// Predicts when the ultrasonic distance sensor has the sample ready that was ordered,
+// so that we read it soon after, instead of wasting bus transactions on it before.
+// The sensor takes the time sound needs to travel the distance twice, plus an overhead
+// that is learned: lowered a little whenever the first read succeeds, and raised by
+// the time spent retrying whenever reads were refused. In practice the module
+// responds in at most 156 ms, depending on the distance measured.
+class ReadySchedule {
+  public:
+    static constexpr uint8_t RETRY_INTERVAL = 2; // ms between reads once one was refused
+
+    struct Counters {
+      uint16_t samples;      // reads that got a sample
+      uint16_t wasted_polls; // reads refused because the sample wasn't ready
+    };
+
+  private:
+    unsigned long read_at; // ms timestamp of the next read
+    uint8_t overhead;      // ms
+    uint8_t refusals;      // of reads for the current sample
+    Counters counters;
+
+  public:
+    ReadySchedule() : read_at(0), overhead(0), refusals(0), counters{0, 0} {}
+
+    // A sample was just ordered; micrometers is the last distance measured.
+    void ordered(unsigned long now, uint32_t micrometers) {
+      // Sound travels 2 * 1000 µm in about 5.83 µs, or 1 ms per 171500 µm,
+      // and 3 / 2^19 ms per µm is close enough given what we learn.
+      uint8_t const flight = uint8_t(micrometers * 3 >> 19);
+      read_at = now + flight + overhead;
+      refusals = 0;
+    }
+
+    // Whether it's time to read the sample.
+    bool due(unsigned long now) const {
+      return long(now - read_at) >= 0;
+    }
+
+    // Milliseconds until it's time to read the sample, 0 if it is.
+    unsigned long until(unsigned long now) const {
+      return due(now) ? 0 : read_at - now;
+    }
+
+    // The read was refused, because the sample isn't ready yet.
+    void refused(unsigned long now) {
+      ++counters.wasted_polls;
+      if (refusals != 0xFF) ++refusals;
+      read_at = now + RETRY_INTERVAL;
+    }
+
+    // The read got the sample.
+    void arrived() {
+      ++counters.samples;
+      if (refusals == 0) {
+        if (overhead > 0) --overhead;
+      } else {
+        uint16_t const later = overhead + refusals * uint16_t{RETRY_INTERVAL};
+        overhead = later > 0xFF ? 0xFF : uint8_t(later);
+      }
+    }
+
+    Counters const& statistics() const {
+      return counters;
+    }
+};
+
+}
@@ -0,0 +1,293 @@
+#include "USI_TWI_Async.h"
+#if USI_TWI_ASYNC
+#include <avr/interrupt.h>
+#include <avr/io.h>
+
+enum USI_TWI_AsyncPhase : unsigned char {
+  USI_TWI_ASYNC_IDLE,      // timer stopped, bus free
+  USI_TWI_ASYNC_HOLDING,   // timer stopped, SCL held low until more is queued
+  USI_TWI_ASYNC_RELEASING, // next tick releases SCL for a repeated START condition
+  USI_TWI_ASYNC_STARTING,  // next tick generates a START condition, once SCL is high
+  USI_TWI_ASYNC_STARTED,   // next tick pulls SCL low and loads the address
+  USI_TWI_ASYNC_SENDING,   // ticks clock out 8 bits
+  USI_TWI_ASYNC_ACK_IN,    // ticks clock in the slave's (N)ACK
+  USI_TWI_ASYNC_STOPPING,  // next tick releases SCL for a STOP condition
+  USI_TWI_ASYNC_STOPPED,   // next tick releases SDA, once SCL is high
+  USI_TWI_ASYNC_BUS_FREE,  // next tick takes up what's queued, if anything
+};
+
+static unsigned char kinds[USI_TWI_ASYNC_QUEUE];
+static unsigned char values[USI_TWI_ASYNC_QUEUE];
+static volatile unsigned char head; // index of the next item taken
+static volatile unsigned char tail; // index of the next item put
+static volatile unsigned char phase = USI_TWI_ASYNC_IDLE;
+static volatile USI_TWI_ErrorLevel error;
+static unsigned char half_period = USI_TWI_ASYNC_MIN_HALF_PERIOD;
+static unsigned char address;       // the address byte after the START condition
+static bool addressing;             // the byte on the bus is the address
+static unsigned char sent;          // the byte on the bus
+static bool garbled;                // the bus didn't carry it as sent
+static unsigned long stalled;       // cycles SCL was held low by the slave
+
+static unsigned char constexpr USI_TWI_Async_USICR =
+  (0 << USISIE) | (1 << USIOIE) | // Overflow interrupt enabled.
+  (1 << USIWM1) | (0 << USIWM0) | // Set USI in Two-wire mode.
+  (1 << USICS1) | (0 << USICS0) |
+  (1 << USICLK) | // Software clock strobe as source.
+  (0 << USITC);
+
+static bool Queued() {
+  return head != tail;
+}
+
+static void Timer() {
+  OCR1C = half_period - 1;
+  OCR1A = half_period - 1;
+  TCNT1 = 0;
+  TCCR1 = (1 << CTC1) | (1 << CS10); // Clear on match with OCR1C, count CPU cycles.
+  TIFR = (1 << OCF1A);
+  TIMSK |= (1 << OCIE1A);
+}
+
+static void Stop_Timer() {
+  TIMSK &= ~(1 << OCIE1A);
+  TCCR1 = 0;
+}
+
+static void Shift(unsigned char usisr, USI_TWI_AsyncPhase next) {
+  phase = next;
+  USISR = usisr;
+}
+
+static void Send(unsigned char msg) {
+  sent = msg;
+  USIDR = msg;
+  Shift(tempUSISR_8bit, USI_TWI_ASYNC_SENDING);
+}
+
+// Give up on the transaction: drop what's queued and stop the bus, unless recovery did already.
+static void Fail(USI_TWI_ErrorLevel err) {
+  if (!error) error = err;
+  head = tail;
+  if (err == USI_TWI_NO_SCL_HI || err == USI_TWI_BUS_STUCK) {
+    Stop_Timer();
+    phase = USI_TWI_ASYNC_IDLE;
+  } else {
+    phase = USI_TWI_ASYNC_STOPPING;
+  }
+}
+
+// Whether the slave holds SCL low although we released it, until it gives up on the transaction.
+static bool Stretched() {
+  if (!(PIN_USI & (1 << PIN_USI_SCL))) {
+    stalled += half_period;
+    if (stalled > USI_TWI_TIMEOUT.count()) {
+      Fail(USI_TWI_Master_Recover());
+    }
+    return true;
+  }
+  stalled = 0;
+  return false;
+}
+
+// With the bus free, take up the next transaction queued, if any, and tell whether there is one.
+static bool Take_Up() {
+  while (Queued()) {
+    unsigned char const kind = kinds[head];
+    unsigned char const value = values[head];
+    head = (head + 1) & (USI_TWI_ASYNC_QUEUE - 1);
+    if (kind == USI_TWI_ASYNC_PERIOD) {
+      half_period = value;
+    } else if (kind == USI_TWI_ASYNC_START) {
+      address = value;
+      phase = USI_TWI_ASYNC_STARTING;
+      return true;
+    }
+  }
+  return false;
+}
+
+// With SCL held low within a transaction, go on with what's queued next, or hold on.
+static void Continue() {
+  if (!Queued()) {
+    Stop_Timer();
+    phase = USI_TWI_ASYNC_HOLDING;
+    return;
+  }
+  unsigned char const kind = kinds[head];
+  unsigned char const value = values[head];
+  head = (head + 1) & (USI_TWI_ASYNC_QUEUE - 1);
+  switch (kind) {
+    case USI_TWI_ASYNC_START:
+      address = value;
+      phase = USI_TWI_ASYNC_RELEASING;
+      return;
+    case USI_TWI_ASYNC_DATA:
+      addressing = false;
+      Send(value);
+      return;
+    case USI_TWI_ASYNC_STOP:
+      phase = USI_TWI_ASYNC_STOPPING;
+      return;
+    default:
+      half_period = value;
+      Continue();
+      return;
+  }
+}
+
+ISR(TIMER1_COMPA_vect) {
+  switch (phase) {
+    case USI_TWI_ASYNC_SENDING:
+    case USI_TWI_ASYNC_ACK_IN:
+      if ((PORT_USI & (1 << PIN_USI_SCL)) && Stretched()) {
+        return;
+      }
+      USICR = USI_TWI_Async_USICR | (1 << USITC); // Toggle SCL, count the edge.
+      return;
+    case USI_TWI_ASYNC_RELEASING:
+      PORT_USI |= (1 << PIN_USI_SCL); // Release SCL, a phase ahead of SDA (tSU;STA).
+      phase = USI_TWI_ASYNC_STARTING;
+      return;
+    case USI_TWI_ASYNC_STARTING:
+      if (Stretched()) {
+        return;
+      }
+      PORT_USI &= ~(1 << PIN_USI_SDA); // Force SDA LOW.
+      phase = USI_TWI_ASYNC_STARTED;
+      return;
+    case USI_TWI_ASYNC_STARTED:
+      PORT_USI &= ~(1 << PIN_USI_SCL); // Pull SCL LOW.
+      PORT_USI |= (1 << PIN_USI_SDA);  // Release SDA.
+      if (!(USISR & (1 << USISIF))) {
+        Fail(USI_TWI_MISSING_START_CON);
+        return;
+      }
+      addressing = true;
+      Send(address);
+      return;
+    case USI_TWI_ASYNC_STOPPING:
+      PORT_USI &= ~(1 << PIN_USI_SDA); // Pull SDA low.
+      PORT_USI |= (1 << PIN_USI_SCL);  // Release SCL.
+      phase = USI_TWI_ASYNC_STOPPED;
+      return;
+    case USI_TWI_ASYNC_STOPPED:
+      if (Stretched()) {
+        return;
+      }
+      PORT_USI |= (1 << PIN_USI_SDA); // Release SDA.
+      if (!(USISR & (1 << USIPF)) && !error) {
+        error = USI_TWI_MISSING_STOP_CON;
+      }
+      phase = USI_TWI_ASYNC_BUS_FREE;
+      return;
+    case USI_TWI_ASYNC_BUS_FREE:
+      if (!Take_Up()) {
+        Stop_Timer();
+        phase = USI_TWI_ASYNC_IDLE;
+      }
+      return;
+    default:
+      return;
+  }
+}
+
+ISR(USI_OVF_vect) {
+  switch (phase) {
+    case USI_TWI_ASYNC_SENDING:
+      garbled = USIDR != sent;
+      DDR_USI &= ~(1 << PIN_USI_SDA); // Enable SDA as input.
+      Shift(tempUSISR_1bit, USI_TWI_ASYNC_ACK_IN);
+      return;
+    case USI_TWI_ASYNC_ACK_IN: {
+      bool const nack = USIDR & (1 << USI_TWI_NACK_BIT);
+      USISR = (1 << USIOIF);
+      USIDR = 0xFF;                  // Release SDA.
+      DDR_USI |= (1 << PIN_USI_SDA); // Enable SDA as output.
+      if (garbled) {
+        Fail(USI_TWI_UE_DATA_COL);
+        return;
+      }
+      if (nack) {
+        Fail(addressing ? USI_TWI_NO_ACK_ON_ADDRESS : USI_TWI_NO_ACK_ON_DATA);
+        return;
+      }
+      Continue();
+      return;
+    }
+    default:
+      USISR = (1 << USIOIF);
+      return;
+  }
+}
+
+void USI_TWI_Async_Initialise() {
+  USI_TWI_Master_Initialise();
+  Stop_Timer();
+  head = tail = 0;
+  error = USI_TWI_OK;
+  phase = USI_TWI_ASYNC_IDLE;
+}
+
+bool USI_TWI_Async_Put(USI_TWI_AsyncKind kind, unsigned char value) {
+  unsigned char const sreg = SREG;
+  cli();
+  bool put = true;
+  if (!error) {
+    unsigned char const next = (tail + 1) & (USI_TWI_ASYNC_QUEUE - 1);
+    if (next == head) {
+      put = false;
+    } else {
+      kinds[tail] = kind;
+      values[tail] = value;
+      tail = next;
+      if (phase == USI_TWI_ASYNC_IDLE) {
+        if (Take_Up()) {
+          // The blocking code may have used the USI since, and after an error left SCL
+          // held low without a STOP condition: release it a phase ahead of the START
+          // condition, as for a repeated START, rather than wait for it to time out.
+          USICR = USI_TWI_Async_USICR;
+          USISR = (1 << USISIF) | (1 << USIOIF) | (1 << USIPF) | (1 << USIDC);
+          if (!(PORT_USI & (1 << PIN_USI_SCL))) {
+            phase = USI_TWI_ASYNC_RELEASING;
+          }
+          Timer();
+        }
+      } else if (phase == USI_TWI_ASYNC_HOLDING) {
+        Continue();
+        if (phase != USI_TWI_ASYNC_HOLDING) {
+          Timer();
+        }
+      }
+    }
+  }
+  SREG = sreg;
+  return put;
+}
+
+USI_TWI_ErrorLevel USI_TWI_Async_Error() {
+  return error;
+}
+
+void USI_TWI_Async_Clear() {
+  error = USI_TWI_OK;
+}
+
+bool USI_TWI_Async_Idle() {
+  unsigned char const now = phase;
+  return now == USI_TWI_ASYNC_IDLE || (now == USI_TWI_ASYNC_HOLDING && !Queued());
+}
+
+void USI_TWI_Async_Lend() {
+  unsigned char const sreg = SREG;
+  cli();
+  phase = USI_TWI_ASYNC_IDLE;
+  USICR = USI_TWI_Async_USICR & ~(1 << USIOIE);
+  USISR = (1 << USIOIF);
+  SREG = sreg;
+}
+
+bool USI_TWI_Async_Bus::open;
+bool USI_TWI_Async_Bus::blocking;
+
+#endif
@@ -0,0 +1,262 @@
+#pragma once
+#include "USI_TWI_Master.h"
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+
+/*****************************************************************************
+  Interrupt driven engine for the USI of ATtiny25/45/85, as an alternative to
+  USI_TWI_Bus for the same devices: I2C::Chat, OLED::Chat and friends queue the
+  bytes they send, and go on formatting the next ones while they're on the bus.
+
+  Timer1 compare match interrupts generate the SCL edges, and the USI counter
+  overflow interrupt (USIOIE) moves on after each byte and acknowledgement,
+  taking addresses, data and STOP conditions from a small queue. One SCL phase
+  lasts the longest of the Device's delays, but at least
+  USI_TWI_ASYNC_MIN_HALF_PERIOD cycles, leaving the main program some time in
+  between interrupts. START, repeated START, STOP and the bus free time after
+  it each take a phase as well.
+
+  Stopping queues the STOP condition and returns right away, and so does the
+  start of the next transaction, queued behind it, so the main program only
+  waits while the queue is full. I2C::pending() tells whether anything queued
+  is still going on, and I2C::result() waits for it to end and tells how it
+  went. Errors thus turn up after the fact: the first one is reported once,
+  by I2C::result() or by whatever the next transaction does first, and the
+  engine drops everything queued after it. So the location of an error may be
+  up to the length of the queue beyond the byte that failed, or in a later
+  transaction. Tracing records the time to queue a transaction, and errors as
+  they're reported. Reading isn't queued: once the queue ran dry, the
+  blocking USI code carries out the rest of that transaction.
+
+  Only built with USI_TWI_ASYNC, since the engine claims Timer1 and the USI
+  overflow interrupt. Devices on USI_TWI_Bus may share the USI with it once
+  I2C::result() of the engine's devices returned. The engine then releases
+  SCL before its next START condition if the blocking code left it held low
+  after an error (host/async_handover.cpp checks that).
+****************************************************************************/
+
+// Whether to build the engine. Change it here rather than in the sketch, so that USI_TWI_Async.cpp agrees.
+#ifndef USI_TWI_ASYNC
+#define USI_TWI_ASYNC 0
+#endif
+
+// The shortest SCL phase, in CPU cycles, that leaves the main program some time between interrupts.
+#ifndef USI_TWI_ASYNC_MIN_HALF_PERIOD
+#define USI_TWI_ASYNC_MIN_HALF_PERIOD 80
+#endif
+
+// Bytes queued at most, a power of 2.
+static unsigned char constexpr USI_TWI_ASYNC_QUEUE = 16;
+
+#if USI_TWI_ASYNC
+
+enum USI_TWI_AsyncKind : unsigned char {
+  USI_TWI_ASYNC_PERIOD, // cycles per SCL phase from now on
+  USI_TWI_ASYNC_START,  // (repeated) START condition and this address byte
+  USI_TWI_ASYNC_DATA,   // this data byte
+  USI_TWI_ASYNC_STOP,   // STOP condition
+};
+
+// Set up the USI and Timer1. Interrupts must be enabled.
+void USI_TWI_Async_Initialise();
+
+// Queue an item, unless the queue is full.
+bool USI_TWI_Async_Put(USI_TWI_AsyncKind kind, unsigned char value);
+
+// The first error since USI_TWI_Async_Clear, after which the engine dropped
+// everything queued up to the transaction's STOP, and stopped the bus itself.
+USI_TWI_ErrorLevel USI_TWI_Async_Error();
+
+// Forget the error, once the engine is idle.
+void USI_TWI_Async_Clear();
+
+// Whether the engine is done with everything queued, and free for the blocking USI code,
+// either between transactions or holding SCL low within one.
+bool USI_TWI_Async_Idle();
+
+// Hand the USI over to the blocking code for the rest of the current transaction.
+// The engine takes over again at the next transaction.
+void USI_TWI_Async_Lend();
+
+// The USI as the engine of I2C::Chat and friends, sending from interrupts.
+class USI_TWI_Async_Bus {
+    static bool open;     // a transaction was started and is still going on
+    static bool blocking; // the rest of it is carried out by the blocking USI code
+
+    static unsigned long Longest(unsigned long a, unsigned long b) {
+      return a > b ? a : b;
+    }
+
+    // Cycles per SCL phase that cover the Device's delays.
+    template <typename Device>
+    static unsigned char Half_Period() {
+      unsigned long const cycles =
+        Longest(Longest(Longest(USI_TWI_ASYNC_MIN_HALF_PERIOD, Device::tHSTART.count()),
+                        Longest(Device::tSSTOP.count(), Device::tIDLE.count())),
+                Longest(Longest(Device::tPRE_SCL_HIGH.count(), Device::tPOST_SCL_HIGH.count()),
+                        Device::tPOST_TRANSFER.count()));
+      return cycles > 255 ? 255 : cycles;
+    }
+
+    // Sleep until the next interrupt, unless the engine is idle already.
+    static void Nap() {
+      cli();
+      if (!USI_TWI_Async_Idle()) {
+        sleep_enable();
+        sei();
+        sleep_cpu();
+        sleep_disable();
+      }
+      sei();
+    }
+
+    static void Put(USI_TWI_AsyncKind kind, unsigned char value) {
+      while (!USI_TWI_Async_Put(kind, value)) {
+        Nap();
+      }
+    }
+
+    // Wait for the engine to be done with what's queued.
+    static USI_TWI_ErrorLevel Settle() {
+      while (!USI_TWI_Async_Idle()) {
+        Nap();
+      }
+      return USI_TWI_Async_Error();
+    }
+
+    // End the transaction on an error, once the engine has stopped the bus, and forget the error reported.
+    static USI_TWI_ErrorLevel Fail(USI_TWI_ErrorLevel err) {
+      Settle();
+      USI_TWI_Async_Clear();
+      open = blocking = false;
+      USI_TWI_Trace_End(err);
+      return err;
+    }
+
+    // Hand over to the blocking code, when the engine is done.
+    static USI_TWI_ErrorLevel Lend() {
+      if (!blocking) {
+        auto err = Settle();
+        if (err) return Fail(err);
+        USI_TWI_Async_Lend();
+        blocking = true;
+      }
+      return USI_TWI_OK;
+    }
+
+    // Like Fail, for errors of the blocking code.
+    static USI_TWI_ErrorLevel Returned(USI_TWI_ErrorLevel err) {
+      if (err) open = blocking = false;
+      return err;
+    }
+
+  public:
+    static void Initialise() {
+      USI_TWI_Async_Initialise();
+    }
+
+    template <typename Device>
+    static USI_TWI_ErrorLevel Start_Sending() {
+      if (blocking) {
+        return Returned(USI_TWI_Master_Start_Sending<Device>());
+      }
+      if (auto err = USI_TWI_Async_Error()) {
+        return Fail(err);
+      }
+      if (!open) {
+        open = true;
+        Put(USI_TWI_ASYNC_PERIOD, Half_Period<Device>());
+      }
+      USI_TWI_Trace_Start(Device::ADDRESS);
+      Put(USI_TWI_ASYNC_START, USI_TWI_Prefix(USI_TWI_SEND, Device::ADDRESS));
+      return USI_TWI_OK;
+    }
+
+    template <typename Device>
+    static USI_TWI_ErrorLevel Start_Receiving() {
+      if (!open) {
+        if (auto err = Settle()) {
+          return Fail(err);
+        }
+        open = true;
+      }
+      auto err = Lend();
+      if (err) return err;
+      return Returned(USI_TWI_Master_Start_Receiving<Device>());
+    }
+
+    template <typename Device>
+    static USI_TWI_ErrorLevel Send(unsigned char msg) {
+      if (blocking) {
+        return Returned(USI_TWI_Master_Send<Device>(msg));
+      }
+      if (auto err = USI_TWI_Async_Error()) {
+        return Fail(err);
+      }
+      Put(USI_TWI_ASYNC_DATA, msg);
+      USI_TWI_Trace_Bytes(1);
+      return USI_TWI_OK;
+    }
+
+    // Queue count bytes, telling how many were queued before an error turned up.
+    template <typename Device, typename Source>
+    static USI_TWI_ErrorLevel Send_Burst(Source source, unsigned int count, unsigned int& sent) {
+      if (blocking) {
+        return Returned(USI_TWI_Master_Send_Burst<Device>(source, count, sent));
+      }
+      for (sent = 0; sent < count; ++sent) {
+        if (auto err = USI_TWI_Async_Error()) {
+          USI_TWI_Trace_Bytes(sent);
+          return Fail(err);
+        }
+        Put(USI_TWI_ASYNC_DATA, source.next());
+      }
+      USI_TWI_Trace_Bytes(sent);
+      return USI_TWI_OK;
+    }
+
+    template <typename Device>
+    static USI_TWI_ErrorLevel Read(unsigned char* buf, unsigned char len) {
+      return Returned(USI_TWI_Master_Read<Device>(buf, len));
+    }
+
+    template <typename Device>
+    static USI_TWI_ErrorLevel Receive(unsigned char* buf, unsigned char len) {
+      if (auto err = Settle()) {
+        return Fail(err);
+      }
+      USI_TWI_Async_Lend();
+      return USI_TWI_Master_Receive<Device>(buf, len);
+    }
+
+    // Queue the STOP condition, without waiting for the transaction to end.
+    template <typename Device>
+    static USI_TWI_ErrorLevel Stop() {
+      if (blocking) {
+        open = blocking = false;
+        return USI_TWI_Master_Stop<Device>();
+      }
+      if (auto err = USI_TWI_Async_Error()) {
+        return Fail(err);
+      }
+      Put(USI_TWI_ASYNC_STOP, 0);
+      open = false;
+      USI_TWI_Trace_End(USI_TWI_OK);
+      return USI_TWI_OK;
+    }
+
+    // Whether transactions stopped are still going on.
+    static bool Pending() {
+      return !USI_TWI_Async_Idle();
+    }
+
+    // Wait for the transactions stopped to end, asleep, and report the first error
+    // that turned up since the last one reported, if any.
+    static USI_TWI_ErrorLevel Result() {
+      auto const err = Settle();
+      USI_TWI_Async_Clear();
+      return err;
+    }
+};
+
+#endif
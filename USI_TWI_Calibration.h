@@ -0,0 +1,86 @@
+#pragma once
+#include <avr/eeprom.h>
+#include "USI_TWI_Master.h"
+
+/*****************************************************************************
+  Calibration of the runtime delays of a device: find the shortest settings
+  at which it still communicates reliably, and keep them in EEPROM so that
+  it's only done once per individual device.
+****************************************************************************/
+
+// How many times in a row a probe must succeed for a setting to be accepted.
+static unsigned char constexpr USI_TWI_CALIBRATION_ROUNDS = 4;
+
+// Marks settings stored in EEPROM, and changes whenever their meaning would
+// (0xD2 since probes check the data, so that settings found without that are found again).
+static unsigned char constexpr USI_TWI_CALIBRATION_MARKER = 0xD2;
+
+// Lower a delay as far as the probe keeps succeeding, searching between zero and its
+// current setting, and then set it to that plus a margin of a quarter and a step.
+// If the probe fails at the current setting already, leave it and return false.
+// The probe is a callable telling whether one conversation with the device succeeded:
+// probe(true) at the current setting, which is known to work, before each setting tried,
+// and probe(false) at that setting, which should also check that what the device said
+// agrees with what it said to probe(true), since an error status only shows so much.
+template <typename Probe>
+bool USI_TWI_Calibrate(USI_TWI_Runtime_Delay& delay, Probe probe) {
+  unsigned char const initial = delay.setting();
+  auto const passes = [&delay, &probe, initial](unsigned char setting) {
+    delay.set(initial);
+    if (!probe(true)) return false;
+    delay.set(setting);
+    for (unsigned char round = 0; round < USI_TWI_CALIBRATION_ROUNDS; ++round) {
+      if (!probe(false)) return false;
+    }
+    return true;
+  };
+  if (!passes(initial)) {
+    delay.set(initial);
+    return false;
+  }
+  unsigned char lo = 0;
+  unsigned char hi = initial; // lowest setting known to pass
+  while (lo < hi) {
+    unsigned char const mid = lo + (hi - lo) / 2;
+    if (passes(mid)) {
+      hi = mid;
+    } else {
+      lo = mid + 1;
+    }
+  }
+  unsigned int const margin = hi + hi / 4 + 1;
+  delay.set(margin > initial ? initial : margin);
+  return true;
+}
+
+static inline unsigned char USI_TWI_Checksum(unsigned char sum, unsigned char setting) {
+  return (sum << 1 | sum >> 7) ^ setting;
+}
+
+// Restore the settings of count delays from EEPROM at address, which takes count + 2 bytes.
+// If no valid settings are stored there, leave the delays and return false.
+static inline bool USI_TWI_Load_Delays(unsigned int address, USI_TWI_Runtime_Delay* const delays[], unsigned char count) {
+  uint8_t const* const stored = reinterpret_cast<uint8_t const*>(address);
+  unsigned char sum = eeprom_read_byte(stored);
+  if (sum != USI_TWI_CALIBRATION_MARKER) return false;
+  for (unsigned char i = 0; i < count; ++i) {
+    sum = USI_TWI_Checksum(sum, eeprom_read_byte(stored + 1 + i));
+  }
+  if (eeprom_read_byte(stored + 1 + count) != sum) return false;
+  for (unsigned char i = 0; i < count; ++i) {
+    delays[i]->set(eeprom_read_byte(stored + 1 + i));
+  }
+  return true;
+}
+
+// Keep the settings of count delays in EEPROM at address, which takes count + 2 bytes.
+static inline void USI_TWI_Store_Delays(unsigned int address, USI_TWI_Runtime_Delay* const delays[], unsigned char count) {
+  uint8_t* const stored = reinterpret_cast<uint8_t*>(address);
+  unsigned char sum = USI_TWI_CALIBRATION_MARKER;
+  eeprom_update_byte(stored, sum);
+  for (unsigned char i = 0; i < count; ++i) {
+    sum = USI_TWI_Checksum(sum, delays[i]->setting());
+    eeprom_update_byte(stored + 1 + i, delays[i]->setting());
+  }
+  eeprom_update_byte(stored + 1 + count, sum);
+}
@@ -25,3 +25,41 @@ void USI_TWI_Master_Initialise() {
           (1 << USIDC) |    // Clear flags,
           (0x0 << USICNT0); // and reset counter.
 }
+
+/*!
+ * @brief Bus recovery after a timeout, following the I2C specification (section 3.1.16).
+ * @return Returns USI_TWI_NO_SCL_HI if the bus was freed, USI_TWI_BUS_STUCK otherwise.
+ */
+USI_TWI_ErrorLevel USI_TWI_Master_Recover() {
+  USICR = (1 << USIWM1) | (0 << USIWM0); // Two-wire mode, but stop clocking the shift register,
+  USIDR = 0xFF;                          // so that it keeps SDA released.
+  PORT_USI |= (1 << PIN_USI_SDA);
+  DDR_USI |= (1 << PIN_USI_SDA);
+  for (unsigned char pulse = 0; pulse < 9 && !(PIN_USI & (1 << PIN_USI_SDA)); ++pulse) {
+    PORT_USI &= ~(1 << PIN_USI_SCL); // Pull SCL LOW.
+    USI_TWI_RECOVERY_HALF_PERIOD.wait();
+    PORT_USI |= (1 << PIN_USI_SCL);  // Release SCL.
+    if (!USI_TWI_Await_SCL_High()) {
+      return USI_TWI_BUS_STUCK;
+    }
+    USI_TWI_RECOVERY_HALF_PERIOD.wait();
+  }
+  if (!(PIN_USI & (1 << PIN_USI_SDA))) {
+    return USI_TWI_BUS_STUCK;
+  }
+
+  /* Generate Stop Condition */
+  PORT_USI &= ~(1 << PIN_USI_SCL); // Pull SCL LOW.
+  PORT_USI &= ~(1 << PIN_USI_SDA); // Pull SDA LOW.
+  USI_TWI_RECOVERY_HALF_PERIOD.wait();
+  PORT_USI |= (1 << PIN_USI_SCL);  // Release SCL.
+  if (!USI_TWI_Await_SCL_High()) {
+    return USI_TWI_BUS_STUCK;
+  }
+  USI_TWI_RECOVERY_HALF_PERIOD.wait();
+  PORT_USI |= (1 << PIN_USI_SDA);  // Release SDA.
+  USI_TWI_RECOVERY_HALF_PERIOD.wait();
+
+  USI_TWI_Master_Initialise();
+  return USI_TWI_NO_SCL_HI;
+}
@@ -1,5 +1,8 @@
 #pragma once
+#include <avr/io.h>
+#include <avr/pgmspace.h>
 #include <math.h>
+#include <util/delay_basic.h>
 
 /*****************************************************************************
   Based on https://github.com/adafruit/TinyWireM
@@ -26,11 +29,12 @@
 // are now lowest numbers so they're easily recognized as LED flashes.
 enum USI_TWI_ErrorLevel : unsigned char {
   USI_TWI_OK = 0,
-  USI_TWI_NO_SCL_HI = 9, //!< SCL did not go high when released.
+  USI_TWI_NO_SCL_HI = 9, //!< SCL did not go high within USI_TWI_TIMEOUT when released; bus recovered since.
+  USI_TWI_BUS_STUCK = 10, //!< Like USI_TWI_NO_SCL_HI, but recovery failed to free the bus.
   USI_TWI_ME_START_CON = 8, //!< Missing Expected Start Condition
   USI_TWI_UE_START_CON = 7, //!< Unexpected Start Condition
   USI_TWI_UE_STOP_CON = 6,  //!< Unexpected Stop Condition
-  USI_TWI_UE_DATA_COL = 5,  //!< Unexpected Data Collision (arbitration, or SDA is simply disconnected)
+  USI_TWI_UE_DATA_COL = 5,  //!< Unexpected Data Collision (arbitration, or SDA is simply disconnected), or a byte sent didn't come back from the bus as sent
   USI_TWI_NO_ACK_ON_DATA = 2, //!< The slave did not acknowledge all data
   USI_TWI_NO_ACK_ON_ADDRESS = 1, //!< The slave did not acknowledge the address
   USI_TWI_MISSING_START_CON = 3, //!< Generated Start Condition not detected on bus
@@ -119,11 +123,75 @@ class USI_TWI_Delay {
         // - 1 because whatever we did before or do next takes at least 1 cycle to have effect
     {}
 
+    constexpr unsigned long count() const {
+      return cycles;
+    }
+
     inline void wait() const {
       __builtin_avr_delay_cycles(cycles);
     }
 };
 
+// The integers of the bit and byte loops of the engines. Built with USI_TWI_COUNTED,
+// on the host, they count the cycles they take on an ATtiny85 (see host/AvrCycles.h),
+// for host/engine_benchmark.cpp to compare the CPU work of the engines.
+#if USI_TWI_COUNTED
+#include "AvrCycles.h"
+template <typename T>
+using USI_TWI_Int = host::Cycles<T>;
+#else
+template <typename T>
+using USI_TWI_Int = T;
+#endif
+
+// How long a slave may stretch the clock, or hold SCL low in general, before
+// we give up on the transaction and try to recover the bus (as SMBus tTIMEOUT).
+static constexpr USI_TWI_Delay USI_TWI_TIMEOUT { 25000 };
+
+// Half the period of the clock pulses sent to recover the bus (i.e. 100 kHz).
+static constexpr USI_TWI_Delay USI_TWI_RECOVERY_HALF_PERIOD { 5 };
+
+// Wait until SCL is high, which the slave may hold off by stretching the clock,
+// but not beyond USI_TWI_TIMEOUT. The count assumes each poll takes 8 cycles.
+static inline bool USI_TWI_Await_SCL_High() {
+  for (USI_TWI_Int<uint32_t> polls = USI_TWI_TIMEOUT.count() / 8; polls != 0; --polls) {
+    if (PIN_USI & (1 << PIN_USI_SCL)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Delay that can be changed at runtime, e.g. by calibration, in steps of 3 cycles.
+class USI_TWI_Runtime_Delay {
+    unsigned char loops;
+
+    static constexpr unsigned char steps(unsigned long cycles) {
+      return (cycles + 2) / 3 > 255 ? 255 : (cycles + 2) / 3;
+    }
+
+  public:
+    constexpr USI_TWI_Runtime_Delay(double us)
+      : loops(steps(USI_TWI_Delay(us).count()))
+    {}
+
+    unsigned char setting() const {
+      return loops;
+    }
+
+    unsigned long count() const {
+      return loops * 3ul;
+    }
+
+    void set(unsigned char setting) {
+      loops = setting;
+    }
+
+    inline void wait() const {
+      if (loops) _delay_loop_1(loops);
+    }
+};
+
 /* Device concept:
 struct Device {
   static constexpr uint8_t ADDRESS;
@@ -134,10 +202,21 @@ struct Device {
   static constexpr USI_TWI_Delay tPOST_SCL_HIGH;
   static constexpr USI_TWI_Delay tPOST_TRANSFER;
 };
+Any of the delays may instead be a static USI_TWI_Runtime_Delay.
+The device may also name the engine of the bus it's on, e.g.
+  using Bus = BitBang_TWI_Bus<PORTB4, PORTB3>;
+or USI_TWI_Async_Bus, and is otherwise on the USI (see I2C::BusOf).
 */
 
 void               USI_TWI_Master_Initialise();
 
+// Free the bus after a timeout: clock out up to 9 pulses on SCL until a slave stuck
+// in the middle of a byte releases SDA, then generate a stop condition and initialise
+// the USI again. Returns USI_TWI_NO_SCL_HI if the bus is free, else USI_TWI_BUS_STUCK.
+USI_TWI_ErrorLevel USI_TWI_Master_Recover();
+
+#include "USI_TWI_Trace.h"
+
 template <typename Device>
 static USI_TWI_ErrorLevel USI_TWI_Master_Start();
 
@@ -146,16 +225,58 @@ static USI_TWI_ErrorLevel USI_TWI_Master_Transmit(unsigned char msg, bool isAddr
 
 template <typename Device>
 USI_TWI_ErrorLevel USI_TWI_Master_Start_Sending() {
+  USI_TWI_Trace_Start(Device::ADDRESS);
   auto err = USI_TWI_Master_Start<Device>();
-  if (err) return err;
-  return USI_TWI_Master_Transmit<Device>(USI_TWI_Prefix(USI_TWI_SEND, Device::ADDRESS), true);
+  if (!err) err = USI_TWI_Master_Transmit<Device>(USI_TWI_Prefix(USI_TWI_SEND, Device::ADDRESS), true);
+  if (err) USI_TWI_Trace_End(err);
+  return err;
+}
+
+template <typename Device>
+USI_TWI_ErrorLevel USI_TWI_Master_Start_Receiving() {
+  USI_TWI_Trace_Start(Device::ADDRESS);
+  auto err = USI_TWI_Master_Start<Device>();
+  if (!err) err = USI_TWI_Master_Transmit<Device>(USI_TWI_Prefix(USI_TWI_RCVE, Device::ADDRESS), true);
+  if (err) USI_TWI_Trace_End(err);
+  return err;
 }
 
 template <typename Device>
 USI_TWI_ErrorLevel USI_TWI_Master_Send(unsigned char msg) {
-  return USI_TWI_Master_Transmit<Device>(msg, false);
+  auto err = USI_TWI_Master_Transmit<Device>(msg, false);
+  if (err) {
+    USI_TWI_Trace_End(err);
+  } else {
+    USI_TWI_Trace_Bytes(1);
+  }
+  return err;
 }
 
+// Sources of the bytes of a burst.
+struct USI_TWI_Ram_Source {
+  unsigned char const* p;
+  unsigned char next() { return *p++; }
+};
+
+struct USI_TWI_Progmem_Source {
+  unsigned char const* p;
+  unsigned char next() { return pgm_read_byte(p++); }
+};
+
+struct USI_TWI_Repeat_Source {
+  unsigned char msg;
+  unsigned char next() { return msg; }
+};
+
+// Send count data bytes, checking the bus state only once beforehand rather than
+// before each byte, and tell how many of them were acknowledged.
+template <typename Device, typename Source>
+USI_TWI_ErrorLevel USI_TWI_Master_Send_Burst(Source source, unsigned int count, unsigned int& sent);
+
+// Read len bytes after USI_TWI_Master_Start_Receiving, acknowledging all but the last.
+template <typename Device>
+USI_TWI_ErrorLevel USI_TWI_Master_Read(unsigned char* buf, unsigned char len);
+
 template <typename Device>
 USI_TWI_ErrorLevel USI_TWI_Master_Receive(unsigned char* buf, unsigned char len);
 
@@ -163,3 +284,54 @@ template <typename Device>
 USI_TWI_ErrorLevel USI_TWI_Master_Stop();
 
 #include "USI_TWI_Master.hpp"
+
+// The USI as the engine of I2C::Chat and friends, i.e. the functions above.
+struct USI_TWI_Bus {
+  static void Initialise() {
+    USI_TWI_Master_Initialise();
+  }
+
+  template <typename Device>
+  static USI_TWI_ErrorLevel Start_Sending() {
+    return USI_TWI_Master_Start_Sending<Device>();
+  }
+
+  template <typename Device>
+  static USI_TWI_ErrorLevel Start_Receiving() {
+    return USI_TWI_Master_Start_Receiving<Device>();
+  }
+
+  template <typename Device>
+  static USI_TWI_ErrorLevel Send(unsigned char msg) {
+    return USI_TWI_Master_Send<Device>(msg);
+  }
+
+  template <typename Device, typename Source>
+  static USI_TWI_ErrorLevel Send_Burst(Source source, unsigned int count, unsigned int& sent) {
+    return USI_TWI_Master_Send_Burst<Device>(source, count, sent);
+  }
+
+  template <typename Device>
+  static USI_TWI_ErrorLevel Read(unsigned char* buf, unsigned char len) {
+    return USI_TWI_Master_Read<Device>(buf, len);
+  }
+
+  template <typename Device>
+  static USI_TWI_ErrorLevel Receive(unsigned char* buf, unsigned char len) {
+    return USI_TWI_Master_Receive<Device>(buf, len);
+  }
+
+  template <typename Device>
+  static USI_TWI_ErrorLevel Stop() {
+    return USI_TWI_Master_Stop<Device>();
+  }
+
+  // Stop() returns once the transaction ended, and reports how it went.
+  static bool Pending() {
+    return false;
+  }
+
+  static USI_TWI_ErrorLevel Result() {
+    return USI_TWI_OK;
+  }
+};
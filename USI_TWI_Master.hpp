@@ -6,7 +6,7 @@
 #include <avr/io.h>
 
 template <typename Device>
-static unsigned char USI_TWI_Master_Transfer(unsigned char);
+static USI_TWI_ErrorLevel USI_TWI_Master_Transfer(unsigned char, unsigned char&);
 
 template <int N>
 static unsigned char constexpr prepUSISR() {
@@ -18,18 +18,15 @@ static unsigned char constexpr tempUSISR_1bit = prepUSISR<1>();
 static unsigned char constexpr tempUSISR_8bit = prepUSISR<8>();
 
 template <typename Device>
-USI_TWI_ErrorLevel USI_TWI_Master_Receive(unsigned char* buf, unsigned char len) {
-  auto err = USI_TWI_Master_Start<Device>();
-  if (err) return err;
-  err = USI_TWI_Master_Transmit<Device>(USI_TWI_Prefix(USI_TWI_RCVE, Device::ADDRESS), true);
-  if (err) return err;
-
+static USI_TWI_ErrorLevel USI_TWI_Master_Read_Bytes(unsigned char* buf, unsigned char len) {
   while (len > 0) {
     --len;
 
     /* Read a data byte */
     DDR_USI &= ~(1 << PIN_USI_SDA); // Enable SDA as input.
-    auto received = USI_TWI_Master_Transfer<Device>(tempUSISR_8bit);
+    unsigned char received;
+    auto err = USI_TWI_Master_Transfer<Device>(tempUSISR_8bit, received);
+    if (err) return err;
     *(buf++) = received;
 
     /* Prepare to generate ACK (or NACK in case of End Of Transmission) */
@@ -39,8 +36,29 @@ USI_TWI_ErrorLevel USI_TWI_Master_Receive(unsigned char* buf, unsigned char len)
     } else {
       USIDR = 0x00; // Load ACK. Set data register bit 7 (output for SDA) low.
     }
-    USI_TWI_Master_Transfer<Device>(tempUSISR_1bit); // Generate ACK/NACK.
+    err = USI_TWI_Master_Transfer<Device>(tempUSISR_1bit, received); // Generate ACK/NACK.
+    if (err) return err;
+  }
+  return USI_TWI_OK;
+}
+
+template <typename Device>
+USI_TWI_ErrorLevel USI_TWI_Master_Read(unsigned char* buf, unsigned char len) {
+  auto err = USI_TWI_Master_Read_Bytes<Device>(buf, len);
+  if (err) {
+    USI_TWI_Trace_End(err);
+  } else {
+    USI_TWI_Trace_Bytes(len);
   }
+  return err;
+}
+
+template <typename Device>
+USI_TWI_ErrorLevel USI_TWI_Master_Receive(unsigned char* buf, unsigned char len) {
+  auto err = USI_TWI_Master_Start_Receiving<Device>();
+  if (err) return err;
+  err = USI_TWI_Master_Read<Device>(buf, len);
+  if (err) return err;
   return USI_TWI_Master_Stop<Device>();
 }
 
@@ -75,12 +93,17 @@ USI_TWI_ErrorLevel USI_TWI_Master_Transmit(unsigned char const msg, bool const i
   /* Write a byte */
   PORT_USI &= ~(1 << PIN_USI_SCL);         // Pull SCL LOW.
   USIDR = msg;                             // Setup data.
-  USI_TWI_Master_Transfer<Device>(tempUSISR_8bit); // Send 8 bits on bus.
+  unsigned char received;
+  auto err = USI_TWI_Master_Transfer<Device>(tempUSISR_8bit, received); // Send 8 bits on bus.
+  if (err) return err;
+  if (USI_TWI_Int<unsigned char>(received) != msg) // The bus didn't carry the bits as sent.
+    return USI_TWI_UE_DATA_COL;
 
   /* Clock and verify (N)ACK from slave */
   DDR_USI &= ~(1 << PIN_USI_SDA); // Enable SDA as input.
-  auto received = USI_TWI_Master_Transfer<Device>(tempUSISR_1bit);
-  if (received & (1 << USI_TWI_NACK_BIT)) {
+  err = USI_TWI_Master_Transfer<Device>(tempUSISR_1bit, received);
+  if (err) return err;
+  if ((USI_TWI_Int<unsigned char>(received) & (1 << USI_TWI_NACK_BIT)) != 0) {
     if (isAddress)
       return USI_TWI_NO_ACK_ON_ADDRESS;
     else
@@ -89,15 +112,61 @@ USI_TWI_ErrorLevel USI_TWI_Master_Transmit(unsigned char const msg, bool const i
   return USI_TWI_OK;
 }
 
+/*!
+ * @brief USI Transmit function for a run of data bytes.
+ *
+ * Like USI_TWI_Master_Transmit, but only checks for unexpected conditions
+ * before the first byte. Afterwards, only the bits the bus carried and the
+ * (N)ACK of each byte are verified.
+ * @param sent Set to the number of bytes acknowledged.
+ */
+template <typename Device, typename Source>
+static USI_TWI_ErrorLevel USI_TWI_Master_Send_Bytes(Source source, unsigned int const count, unsigned int& sent) {
+  sent = 0;
+  auto const status = USISR;
+  if (status & (1 << USISIF))
+    return USI_TWI_UE_START_CON;
+  if (status & (1 << USIPF))
+    return USI_TWI_UE_STOP_CON;
+  if (status & (1 << USIDC))
+    return USI_TWI_UE_DATA_COL;
+
+  PORT_USI &= ~(1 << PIN_USI_SCL); // Pull SCL LOW (the USI leaves it low after each byte).
+  for (; sent < count; ++sent) {
+    unsigned char const msg = source.next();
+    USIDR = msg;
+    unsigned char received;
+    auto err = USI_TWI_Master_Transfer<Device>(tempUSISR_8bit, received);
+    if (err) return err;
+    if (USI_TWI_Int<unsigned char>(received) != msg)
+      return USI_TWI_UE_DATA_COL;
+    DDR_USI &= ~(1 << PIN_USI_SDA);
+    err = USI_TWI_Master_Transfer<Device>(tempUSISR_1bit, received);
+    if (err) return err;
+    if ((USI_TWI_Int<unsigned char>(received) & (1 << USI_TWI_NACK_BIT)) != 0)
+      return USI_TWI_NO_ACK_ON_DATA;
+  }
+  return USI_TWI_OK;
+}
+
+template <typename Device, typename Source>
+USI_TWI_ErrorLevel USI_TWI_Master_Send_Burst(Source source, unsigned int const count, unsigned int& sent) {
+  auto err = USI_TWI_Master_Send_Bytes<Device>(source, count, sent);
+  USI_TWI_Trace_Bytes(sent);
+  if (err) USI_TWI_Trace_End(err);
+  return err;
+}
+
 /*!
  * @brief Core function for shifting data in and out from the USI.
  * Data to be sent has to be placed into the USIDR prior to calling
- * this function. Data read, will be return'ed from the function.
+ * this function.
  * @param temp Temporary value for the USISR
- * @return Returns the value read from the device
+ * @param received Set to the value read from the device
+ * @return Returns USI_TWI_OK, or the outcome of bus recovery if the slave held SCL low too long.
  */
 template <typename Device>
-unsigned char USI_TWI_Master_Transfer(unsigned char temp) {
+USI_TWI_ErrorLevel USI_TWI_Master_Transfer(unsigned char temp, unsigned char& received) {
   USISR = temp;                          // Set USISR according to temp.
                                          // Prepare clocking.
   temp = (0 << USISIE) | (0 << USIOIE) | // Interrupts disabled
@@ -108,18 +177,18 @@ unsigned char USI_TWI_Master_Transfer(unsigned char temp) {
   do {
     Device::tPRE_SCL_HIGH.wait();
     USICR = temp; // Generate positve SCL edge.
-    while (!(PIN_USI & (1 << PIN_USI_SCL)))
-      ; // Wait for SCL to go high.
+    if (!USI_TWI_Await_SCL_High()) // Wait for SCL to go high.
+      return USI_TWI_Master_Recover();
     Device::tPOST_SCL_HIGH.wait();
     USICR = temp;                     // Generate negative SCL edge.
-  } while (!(USISR & (1 << USIOIF))); // Check for transfer complete.
+  } while ((USI_TWI_Int<unsigned char>(USISR) & (1 << USIOIF)) == 0); // Check for transfer complete.
 
   Device::tPOST_TRANSFER.wait();
-  temp = USIDR;                  // Read out data.
+  received = USIDR;              // Read out data.
   USIDR = 0xFF;                  // Release SDA.
   DDR_USI |= (1 << PIN_USI_SDA); // Enable SDA as output.
 
-  return temp; // Return the data from the USIDR
+  return USI_TWI_OK;
 }
 
 /*!
@@ -130,13 +199,10 @@ template <typename Device>
 USI_TWI_ErrorLevel USI_TWI_Master_Start() {
   /* Release SCL to ensure that (repeated) Start can be performed */
   PORT_USI |= (1 << PIN_USI_SCL); // Release SCL.
-  unsigned char counter = 0;
-  while (!(PORT_USI & (1 << PIN_USI_SCL))) {
-    ; // Verify that SCL becomes high.
-    if (++counter == 0) {
-      return USI_TWI_NO_SCL_HI;
-    }
+  if (!USI_TWI_Await_SCL_High()) { // Verify that SCL becomes high.
+    return USI_TWI_Master_Recover();
   }
+  Device::tHSTART.wait(); // Both lines high before a repeated START (tSU;STA, as long as tHD;STA).
 
   /* Generate Start Condition */
   PORT_USI &= ~(1 << PIN_USI_SDA); // Force SDA LOW.
@@ -157,15 +223,11 @@ USI_TWI_ErrorLevel USI_TWI_Master_Start() {
  * @return Returns USI_TWI_OK if it was successful, otherwise returns error code.
  */
 template <typename Device>
-USI_TWI_ErrorLevel USI_TWI_Master_Stop() {
+static USI_TWI_ErrorLevel USI_TWI_Master_Stop_Condition() {
   PORT_USI &= ~(1 << PIN_USI_SDA); // Pull SDA low.
   PORT_USI |= (1 << PIN_USI_SCL);  // Release SCL.
-  unsigned char counter = 0;
-  while (!(PIN_USI & (1 << PIN_USI_SCL))) {
-    ; // Wait for SCL to go high.
-    if (++counter == 0) {
-      return USI_TWI_NO_SCL_HI;
-    }
+  if (!USI_TWI_Await_SCL_High()) { // Wait for SCL to go high.
+    return USI_TWI_Master_Recover();
   }
   Device::tSSTOP.wait();
   PORT_USI |= (1 << PIN_USI_SDA); // Release SDA.
@@ -177,3 +239,10 @@ USI_TWI_ErrorLevel USI_TWI_Master_Stop() {
 
   return USI_TWI_OK;
 }
+
+template <typename Device>
+USI_TWI_ErrorLevel USI_TWI_Master_Stop() {
+  auto err = USI_TWI_Master_Stop_Condition<Device>();
+  USI_TWI_Trace_End(err);
+  return err;
+}
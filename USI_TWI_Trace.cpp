@@ -0,0 +1,69 @@
+#include "USI_TWI_Master.h"
+#if USI_TWI_TRACE
+#include <Arduino.h>
+
+static USI_TWI_Trace_Record ring[USI_TWI_TRACE_RECORDS];
+static unsigned char next;    // index in ring of the next record
+static unsigned char count;   // records kept
+static bool open;             // the latest record is of the transaction going on
+
+static uint16_t ticks() {
+  return uint16_t(micros() >> 2);
+}
+
+static USI_TWI_Trace_Record& latest() {
+  return ring[(next - 1) & (USI_TWI_TRACE_RECORDS - 1)];
+}
+
+void USI_TWI_Trace_Start(unsigned char address) {
+  if (open) return; // repeated start
+  open = true;
+  if (count != 0 && latest().address == address && latest().error == USI_TWI_NO_ACK_ON_ADDRESS) {
+    USI_TWI_Trace_Record& record = latest();
+    if (record.retries != 0xFF) ++record.retries;
+    record.error = USI_TWI_OK;
+    return;
+  }
+  USI_TWI_Trace_Record& record = ring[next];
+  next = (next + 1) & (USI_TWI_TRACE_RECORDS - 1);
+  if (count < USI_TWI_TRACE_RECORDS) ++count;
+  record.start = ticks();
+  record.duration = 0;
+  record.address = address;
+  record.bytes = 0;
+  record.retries = 0;
+  record.error = USI_TWI_OK;
+}
+
+void USI_TWI_Trace_Bytes(unsigned int count) {
+  if (!open) return;
+  USI_TWI_Trace_Record& record = latest();
+  unsigned int const bytes = record.bytes + count;
+  record.bytes = bytes > 0xFF ? 0xFF : (unsigned char)bytes;
+}
+
+void USI_TWI_Trace_End(USI_TWI_ErrorLevel err) {
+  if (!open) return;
+  open = false;
+  USI_TWI_Trace_Record& record = latest();
+  record.duration = ticks() - record.start;
+  record.error = err;
+}
+
+unsigned char USI_TWI_Trace_Count() {
+  return count;
+}
+
+USI_TWI_Trace_Record const& USI_TWI_Trace_At(unsigned char index) {
+  return ring[(next - count + index) & (USI_TWI_TRACE_RECORDS - 1)];
+}
+
+USI_TWI_Trace_Record const* USI_TWI_Trace_Latest(unsigned char address) {
+  for (unsigned char i = count; i > 0; --i) {
+    USI_TWI_Trace_Record const& record = USI_TWI_Trace_At(i - 1);
+    if (record.address == address) return &record;
+  }
+  return nullptr;
+}
+
+#endif
@@ -0,0 +1,51 @@
+#pragma once
+
+/*****************************************************************************
+  Optional tracing of transactions on the bus, for profiling where time goes:
+  a ring of records of the latest transactions, each with its device address,
+  start time and duration in ticks of 4 µs (the resolution of micros(), which
+  counts Timer0), number of data bytes transferred, number of retries and outcome.
+  Attempts that the device didn't acknowledge are not recorded separately, but
+  count as retries of the next transaction with the same device.
+  Included by USI_TWI_Master.h; without USI_TWI_TRACE, the trace points are empty.
+****************************************************************************/
+
+// Whether to trace. Change it here rather than in the sketch, so that USI_TWI_Trace.cpp agrees.
+#ifndef USI_TWI_TRACE
+#define USI_TWI_TRACE 0
+#endif
+
+#if USI_TWI_TRACE
+
+static unsigned char constexpr USI_TWI_TRACE_RECORDS = 8; // power of 2
+
+struct USI_TWI_Trace_Record {
+  uint16_t start;           // ticks, truncated
+  uint16_t duration;        // ticks from start to stop, or to the error
+  unsigned char address;
+  unsigned char bytes;      // data bytes transferred, up to 255
+  unsigned char retries;    // earlier attempts not acknowledged, up to 255
+  USI_TWI_ErrorLevel error; // USI_TWI_OK if stopped successfully
+};
+
+// Trace points, at the start or repeated start, at data transferred, and at the end of a transaction.
+void USI_TWI_Trace_Start(unsigned char address);
+void USI_TWI_Trace_Bytes(unsigned int count);
+void USI_TWI_Trace_End(USI_TWI_ErrorLevel err);
+
+// Number of records kept, up to USI_TWI_TRACE_RECORDS.
+unsigned char USI_TWI_Trace_Count();
+
+// A record kept, from 0 for the oldest to USI_TWI_Trace_Count() - 1 for the latest.
+USI_TWI_Trace_Record const& USI_TWI_Trace_At(unsigned char index);
+
+// The latest record of a transaction with the device at address, or nullptr.
+USI_TWI_Trace_Record const* USI_TWI_Trace_Latest(unsigned char address);
+
+#else
+
+static inline void USI_TWI_Trace_Start(unsigned char) {}
+static inline void USI_TWI_Trace_Bytes(unsigned int) {}
+static inline void USI_TWI_Trace_End(USI_TWI_ErrorLevel) {}
+
+#endif
@@ -0,0 +1,42 @@
+#pragma once
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "avr/io.h"
+#include "avr/pgmspace.h"
+
+// Host stand-in for the parts of the Arduino core this sketch uses.
+// Time only passes through delay(), through the emulated bus, and through
+// reading the time, which costs about as much as the real millis() and
+// thus lets a sketch that polls the time make progress. Like the real ones,
+// millis() and micros() count with Timer0, which runs slow on a prescaled
+// clock and stands still in power-down.
+
+typedef uint8_t byte;
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define LED_BUILTIN 1
+
+inline void pinMode(uint8_t, uint8_t) {}
+inline void digitalWrite(uint8_t, uint8_t) {}
+
+inline unsigned long millis() {
+  ::host::emulator().idle_cycles(40);
+  return ::host::emulator().timer0 / (F_CPU / 1000);
+}
+
+inline unsigned long micros() {
+  ::host::emulator().idle_cycles(40);
+  return ::host::emulator().timer0 / (F_CPU / 1000000);
+}
+
+inline void delay(unsigned long ms) {
+  ::host::emulator().idle_cycles(ms * (F_CPU / 1000));
+}
+
+inline void delayMicroseconds(unsigned int us) {
+  ::host::emulator().idle_cycles(us * (F_CPU / 1000000));
+}
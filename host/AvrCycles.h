@@ -0,0 +1,168 @@
+#pragma once
+#include <stdint.h>
+#include <type_traits>
+
+/*****************************************************************************
+  Host-side count of the AVR cycles that integer arithmetic takes, for
+  benchmarks of code templated on its integer types, such as Digits.
+  Cycles<T> behaves like T and charges avr_cycles() for each operation with
+  what the ATtiny85 spends on it:
+  - a cycle per byte for logic, addition and subtraction;
+  - a cycle per byte and bit for shifts, but only a move per byte for whole
+    bytes shifted;
+  - a cycle per byte plus one for the branch for comparisons and tests;
+  - two cycles per byte for each copy loaded or stored.
+  Division and remainder call libgcc's __udivmodqi4, __udivmodhi4 or
+  __udivmodsi4. Their instructions are counted exactly, including the
+  branches that depend on the operands. A remainder of the same operands
+  right after the quotient (or the other way round) comes with it, as avr-gcc
+  arranges. Loop counters of plain types and register moves aren't charged.
+****************************************************************************/
+
+namespace host {
+
+inline unsigned long& avr_cycles() {
+  static unsigned long count = 0;
+  return count;
+}
+
+// Cycles of libgcc's division routines, from the rcall to the ret.
+template <typename T>
+unsigned long udivmod_cycles(T dividend, T divisor) {
+  static_assert(sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4, "__udivmodqi4, hi4 or si4");
+  unsigned constexpr BYTES = sizeof(T);
+  unsigned constexpr BITS = 8 * BYTES;
+  // Setup, BITS + 1 passes of the entry point (ROL per byte, DEC, BRNE), the complemented
+  // quotient, results moved with MOVW, RET and RCALL.
+  unsigned long const fixed[] = { 0, 4 + 0 + 1 + 4, 5 + 2 + 2 + 4, 0, 7 + 4 + 4 + 4 };
+  unsigned long cycles = fixed[BYTES] + (BITS + 1) * (BYTES + 1) + 2 * BITS + 1 + 3;
+  uint64_t remainder = 0;
+  for (unsigned bit = BITS; bit-- > 0;) {
+    remainder = remainder << 1 | (uint64_t(dividend) >> bit & 1);
+    cycles += 2 * BYTES; // ROL and CP/CPC per byte
+    if (remainder < divisor) {
+      cycles += 2; // BRCS taken
+    } else {
+      remainder -= divisor;
+      cycles += 1 + BYTES; // BRCS not taken, SUB/SBC per byte
+    }
+  }
+  return cycles;
+}
+
+template <typename T>
+class Cycles {
+    static_assert(std::is_integral<T>::value, "integers only");
+    static constexpr unsigned BYTES = sizeof(T);
+
+    T value;
+
+    static T charge(unsigned long cycles, T result) {
+      avr_cycles() += cycles;
+      return result;
+    }
+
+    // Charge at runtime only, e.g. not in static_assert.
+    static constexpr T charged(unsigned long cycles, T result) {
+      return __builtin_is_constant_evaluated() ? result : charge(cycles, result);
+    }
+
+    static unsigned long shift_cycles(unsigned bits) {
+      unsigned const bytes = bits / 8 < BYTES ? bits / 8 : BYTES;
+      return (bytes ? BYTES : 0) + bits % 8 * (BYTES - bytes);
+    }
+
+    // The division routine's cycles, unless these operands were just divided.
+    static unsigned long divide(T dividend, T divisor) {
+      static T last_dividend, last_divisor;
+      static bool paired = true;
+      if (!paired && dividend == last_dividend && divisor == last_divisor) {
+        paired = true;
+        return 0;
+      }
+      paired = false;
+      last_dividend = dividend;
+      last_divisor = divisor;
+      using U = typename std::make_unsigned<T>::type;
+      // __divmodhi4 around __udivmodhi4, for operands that aren't negative.
+      static_assert(!std::is_signed<T>::value || BYTES == 2, "signed division of ints only");
+      return udivmod_cycles<U>(U(dividend), U(divisor)) + (std::is_signed<T>::value ? 17 : 0);
+    }
+
+  public:
+    constexpr Cycles(T value = 0) : value(value) {}
+
+    template <typename U>
+    explicit constexpr Cycles(Cycles<U> other) : value(T(U(other))) {}
+
+    constexpr Cycles(Cycles const& other) : value(charged(2 * BYTES, other.value)) {}
+
+    Cycles& operator=(Cycles const& other) {
+      value = charge(2 * BYTES, other.value);
+      return *this;
+    }
+
+    constexpr operator T() const {
+      return value;
+    }
+
+    constexpr Cycles operator~() const {
+      return Cycles(charged(BYTES, T(~value)));
+    }
+
+    bool operator!() const {
+      return charge(BYTES + 1, !value);
+    }
+
+    template <typename V>
+    Cycles operator&(V const& other) const { return charge(BYTES, T(value & T(other))); }
+    template <typename V>
+    Cycles operator|(V const& other) const { return charge(BYTES, T(value | T(other))); }
+    template <typename V>
+    Cycles operator^(V const& other) const { return charge(BYTES, T(value ^ T(other))); }
+    template <typename V>
+    Cycles operator+(V const& other) const { return charge(BYTES, T(value + T(other))); }
+    template <typename V>
+    Cycles operator-(V const& other) const { return charge(BYTES, T(value - T(other))); }
+    template <typename V>
+    Cycles operator/(V const& other) const { return charge(divide(value, T(other)), T(value / T(other))); }
+    template <typename V>
+    Cycles operator%(V const& other) const { return charge(divide(value, T(other)), T(value % T(other))); }
+    template <typename V>
+    Cycles operator<<(V bits) const { return charge(shift_cycles(bits), T(value << bits)); }
+    template <typename V>
+    Cycles operator>>(V bits) const { return charge(shift_cycles(bits), T(value >> bits)); }
+
+    // In place, without a store.
+    Cycles& operator++() { value = charge(BYTES, T(value + 1)); return *this; }
+    Cycles& operator--() { value = charge(BYTES, T(value - 1)); return *this; }
+    template <typename V>
+    Cycles& operator&=(V const& other) { value = (*this & other).value; return *this; }
+    template <typename V>
+    Cycles& operator|=(V const& other) { value = (*this | other).value; return *this; }
+    template <typename V>
+    Cycles& operator+=(V const& other) { value = (*this + other).value; return *this; }
+    template <typename V>
+    Cycles& operator-=(V const& other) { value = (*this - other).value; return *this; }
+    template <typename V>
+    Cycles& operator/=(V const& other) { value = (*this / other).value; return *this; }
+    template <typename V>
+    Cycles& operator<<=(V bits) { value = (*this << bits).value; return *this; }
+    template <typename V>
+    Cycles& operator>>=(V bits) { value = (*this >> bits).value; return *this; }
+
+    template <typename V>
+    constexpr bool operator==(V const& other) const { return charged(BYTES + 1, value == T(other)); }
+    template <typename V>
+    constexpr bool operator!=(V const& other) const { return charged(BYTES + 1, value != T(other)); }
+    template <typename V>
+    constexpr bool operator<(V const& other) const { return charged(BYTES + 1, value < T(other)); }
+    template <typename V>
+    constexpr bool operator>(V const& other) const { return charged(BYTES + 1, value > T(other)); }
+    template <typename V>
+    constexpr bool operator<=(V const& other) const { return charged(BYTES + 1, value <= T(other)); }
+    template <typename V>
+    constexpr bool operator>=(V const& other) const { return charged(BYTES + 1, value >= T(other)); }
+};
+
+}
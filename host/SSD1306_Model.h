@@ -0,0 +1,290 @@
+#pragma once
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include "USI_Emulator.h"
+
+/*****************************************************************************
+  Host-side model of an SSD1306 with 128x64 pixels, attached to the emulated
+  bus, decoding the byte stream of OLED::Chat into its display RAM. The panel
+  is wired as on 128x64 modules, for the alternative COM pin configuration:
+  its lines are driven by COM0, COM32, COM1, COM33 and so on, from the top.
+****************************************************************************/
+
+namespace host {
+
+class SSD1306_Model : public Slave {
+  public:
+    static constexpr uint8_t WIDTH = 128;
+    static constexpr uint8_t HEIGHT = 64;
+    static constexpr uint8_t PAGES = HEIGHT / 8;
+
+    enum Addressing : uint8_t { HORIZONTAL = 0b00, VERTICAL = 0b01, PAGE = 0b10 };
+
+    // What crossed the bus since construction or the last take_frame().
+    struct Traffic {
+      unsigned long control_bytes;
+      unsigned long command_bytes;
+      unsigned long data_bytes;
+      unsigned long unknown_commands;
+
+      Traffic() : control_bytes(0), command_bytes(0), data_bytes(0), unknown_commands(0) {}
+
+      unsigned long bytes() const {
+        return control_bytes + command_bytes + data_bytes;
+      }
+    };
+
+    uint8_t ram[PAGES][WIDTH]; // GDDRAM, one byte per page and column, LSB at the top
+    Addressing addressing;
+    uint8_t column, column_start, column_end;
+    uint8_t page, page_start, page_end;
+    uint8_t start_line;     // 0x40 | n
+    uint8_t display_offset; // 0xD3 n
+    uint8_t multiplex;      // 0xA8 n, i.e. number of displayed rows - 1
+    uint8_t com_pins;       // 0xDA n, i.e. 0x02 | alternative << 4 | left/right remap << 5
+    uint8_t contrast;
+    bool enabled;
+    bool charge_pump;
+    bool scrolling;
+    Traffic traffic;
+
+    explicit SSD1306_Model(uint8_t address = 0x3C) : addr(address) {
+      reset();
+    }
+
+    // Power-on state, except that RAM is cleared rather than random.
+    void reset() {
+      for (uint8_t p = 0; p < PAGES; ++p) {
+        for (uint8_t x = 0; x < WIDTH; ++x) {
+          ram[p][x] = 0;
+        }
+      }
+      addressing = PAGE;
+      column = column_start = 0;
+      column_end = WIDTH - 1;
+      page = page_start = 0;
+      page_end = PAGES - 1;
+      start_line = display_offset = 0;
+      multiplex = HEIGHT - 1;
+      com_pins = 0x12;
+      contrast = 0x7F;
+      enabled = charge_pump = scrolling = false;
+      traffic = Traffic();
+      expect = CONTROL;
+      argc = 0;
+    }
+
+    // Return the traffic of the frame just drawn, and start counting the next one.
+    Traffic take_frame() {
+      Traffic frame = traffic;
+      traffic = Traffic();
+      return frame;
+    }
+
+    bool pixel(uint8_t x, uint8_t y) const {
+      return ram[y / 8][x] >> (y % 8) & 1;
+    }
+
+    // Which row the controller scans out on line y of the panel, given the COM pin
+    // configuration: rows in sequence on COM0 to COM63, or alternately on COM0 to COM31
+    // and COM32 to COM63, either beginning with COM32 if remapped.
+    uint8_t row(uint8_t y) const {
+      uint8_t const com = y % 2 ? HEIGHT / 2 + y / 2 : y / 2;
+      uint8_t const remapped = com_pins & 0x20 ? com ^ HEIGHT / 2 : com;
+      if (com_pins & 0x10) {
+        return remapped < HEIGHT / 2 ? 2 * remapped : 2 * (remapped - HEIGHT / 2) + 1;
+      }
+      return remapped;
+    }
+
+    // Whether the pixel at line y of the panel lights up, taking into account the
+    // COM pin configuration, start line, display offset and multiplex ratio.
+    bool lit(uint8_t x, uint8_t y) const {
+      uint8_t const r = row(y);
+      if (!enabled || r > multiplex) return false;
+      return pixel(x, uint8_t((r + start_line + display_offset) % HEIGHT));
+    }
+
+    // Plain PBM (P1) image of display RAM, or of the panel if displayed.
+    // Being text, it serves well as a golden image to diff against.
+    std::string pbm(bool displayed = false) const {
+      std::string s = "P1\n" + std::to_string(WIDTH) + " " + std::to_string(HEIGHT) + "\n";
+      for (uint8_t y = 0; y < HEIGHT; ++y) {
+        for (uint8_t x = 0; x < WIDTH; ++x) {
+          s += (displayed ? lit(x, y) : pixel(x, y)) ? '1' : '0';
+        }
+        s += '\n';
+      }
+      return s;
+    }
+
+    // Plain PGM (P2) image of the panel, with lit pixels as bright as the contrast setting.
+    std::string pgm() const {
+      std::string s = "P2\n" + std::to_string(WIDTH) + " " + std::to_string(HEIGHT) + "\n255\n";
+      for (uint8_t y = 0; y < HEIGHT; ++y) {
+        for (uint8_t x = 0; x < WIDTH; ++x) {
+          s += std::to_string(lit(x, y) ? contrast : 0);
+          s += x + 1 < WIDTH ? ' ' : '\n';
+        }
+      }
+      return s;
+    }
+
+    bool save(char const* path, std::string const& image) const {
+      FILE* f = fopen(path, "w");
+      if (!f) return false;
+      bool ok = fwrite(image.data(), 1, image.size(), f) == image.size();
+      return fclose(f) == 0 && ok;
+    }
+
+    uint8_t address() const override {
+      return addr;
+    }
+
+    bool select(bool reading) override {
+      expect = CONTROL;
+      return !reading; // the SSD1306 in I2C mode cannot be read
+    }
+
+    bool write(uint8_t b) override {
+      switch (expect) {
+        case CONTROL:
+          ++traffic.control_bytes;
+          if (b & 0x3F) return false; // not a control byte
+          data = b & 0x40;
+          expect = b & 0x80 ? SINGLE : STREAM;
+          return true;
+        case SINGLE:
+          expect = CONTROL;
+          break;
+        case STREAM:
+          break;
+      }
+      if (data) {
+        ++traffic.data_bytes;
+        store(b);
+      } else {
+        ++traffic.command_bytes;
+        command(b);
+      }
+      return true;
+    }
+
+  private:
+    enum Expect : uint8_t { CONTROL, SINGLE, STREAM };
+
+    uint8_t const addr;
+    Expect expect;
+    bool data;
+    uint8_t cmd;
+    uint8_t argc;    // arguments still expected by cmd
+    uint8_t args[7];
+    uint8_t argn;
+
+    static uint8_t argument_count(uint8_t c) {
+      switch (c) {
+        case 0x20: case 0x81: case 0x8D: case 0xA8: case 0xD3:
+        case 0xD5: case 0xD9: case 0xDA: case 0xDB:
+          return 1;
+        case 0x21: case 0x22: case 0xA3:
+          return 2;
+        case 0x29: case 0x2A:
+          return 5;
+        case 0x26: case 0x27: case 0x2C: case 0x2D:
+          return 6;
+        default:
+          return 0;
+      }
+    }
+
+    void command(uint8_t b) {
+      if (argc) {
+        args[argn++] = b;
+        if (--argc == 0) execute();
+        return;
+      }
+      cmd = b;
+      argn = 0;
+      argc = argument_count(b);
+      if (argc == 0) execute();
+    }
+
+    void execute() {
+      if (cmd <= 0x0F) {
+        column = (column & 0xF0) | cmd;
+      } else if (cmd <= 0x1F) {
+        column = uint8_t((column & 0x0F) | (cmd & 0x07) << 4);
+      } else if (cmd >= 0x40 && cmd <= 0x7F) {
+        start_line = cmd & 0x3F;
+      } else if (cmd >= 0xB0 && cmd <= 0xB7) {
+        page = cmd & 0x07;
+      } else {
+        switch (cmd) {
+          case 0x20: addressing = Addressing(args[0] & 0b11); break;
+          case 0x21:
+            column = column_start = args[0] & 0x7F;
+            column_end = args[1] & 0x7F;
+            break;
+          case 0x22:
+            page = page_start = args[0] & 0x07;
+            page_end = args[1] & 0x07;
+            break;
+          case 0x81: contrast = args[0]; break;
+          case 0x8D: charge_pump = args[0] & 0x04; break;
+          case 0xA8: multiplex = args[0] & 0x3F; break;
+          case 0xD3: display_offset = args[0] & 0x3F; break;
+          case 0xDA: com_pins = args[0] & 0x32; break;
+          case 0xAE: case 0xAF: enabled = cmd & 1; break;
+          case 0x2E: scrolling = false; break;
+          case 0x2F: scrolling = true; break;
+          case 0x2C: case 0x2D: content_scroll(cmd == 0x2C, args[1] & 0x07, args[3] & 0x07, args[4] & 0x7F, args[5] & 0x7F); break;
+          case 0x26: case 0x27: case 0x29: case 0x2A: case 0xA3:
+          case 0xA0: case 0xA1: case 0xA4: case 0xA5: case 0xA6: case 0xA7:
+          case 0xC0: case 0xC8: case 0xD5: case 0xD9: case 0xDB: case 0xE3:
+            break; // accepted, but not affecting the RAM model
+          default:
+            ++traffic.unknown_commands;
+        }
+      }
+    }
+
+    // Rotate the RAM of a window by one column, right (0x2C) or left (0x2D).
+    void content_scroll(bool right, uint8_t p0, uint8_t p1, uint8_t x0, uint8_t x1) {
+      if (x0 >= x1) return;
+      for (uint8_t p = p0; p <= p1; ++p) {
+        if (right) {
+          uint8_t const wrapped = ram[p][x1];
+          for (uint8_t x = x1; x > x0; --x) ram[p][x] = ram[p][x - 1];
+          ram[p][x0] = wrapped;
+        } else {
+          uint8_t const wrapped = ram[p][x0];
+          for (uint8_t x = x0; x < x1; ++x) ram[p][x] = ram[p][x + 1];
+          ram[p][x1] = wrapped;
+        }
+      }
+    }
+
+    void store(uint8_t b) {
+      ram[page][column] = b;
+      switch (addressing) {
+        case HORIZONTAL:
+          if (column++ == column_end) {
+            column = column_start;
+            if (page++ == page_end) page = page_start;
+          }
+          break;
+        case VERTICAL:
+          if (page++ == page_end) {
+            page = page_start;
+            if (column++ == column_end) column = column_start;
+          }
+          break;
+        default:
+          if (column++ == column_end) column = column_start;
+          break;
+      }
+    }
+};
+
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <stdint.h>
+#include "avr/io.h"
+#include "USI_Emulator.h"
+
+/*****************************************************************************
+  Host-side model of the ultrasonic distance sensor in I2C mode, attached to
+  the emulated bus: writing 1 orders a sample, and until it's ready, a read
+  isn't acknowledged. Then it supplies the 3 bytes of the distance in
+  micrometers, most significant first. Optionally, it garbles them when
+  clocked faster than it keeps up with, as real ones do without any error.
+****************************************************************************/
+
+namespace host {
+
+class USDS_Model : public Slave {
+  public:
+    // The distance of the n-th sample ordered, in micrometers.
+    typedef uint32_t (*Trace)(unsigned long n);
+
+    unsigned long ranging_cycles; // from the order until the sample is ready
+    unsigned long orders;         // samples ordered
+    unsigned long reads;          // reads acknowledged, i.e. of samples ready
+    unsigned long min_bit_cycles; // if clocked faster, each bit sent comes a bit late; 0 for never
+
+    explicit USDS_Model(Trace trace, uint8_t address = 0x57)
+      : ranging_cycles(60 * (F_CPU / 1000)), orders(0), reads(0), min_bit_cycles(0),
+        trace(trace), addr(address), ordered_at(0), sample(0), index(0), byte_at(0), last_bit(true) {}
+
+    uint8_t address() const override {
+      return addr;
+    }
+
+    bool select(bool reading) override {
+      index = 0;
+      byte_at = emulator().clock;
+      last_bit = true;
+      if (!reading) return true;
+      if (orders == 0 || emulator().clock - ordered_at < ranging_cycles) return false;
+      ++reads;
+      return true;
+    }
+
+    bool write(uint8_t b) override {
+      if (b == 1) {
+        sample = trace(orders++);
+        ordered_at = emulator().clock;
+      }
+      return true;
+    }
+
+    uint8_t read() override {
+      uint8_t const b = index < 3 ? uint8_t(sample >> (16 - 8 * index)) : 0xFF;
+      // Since the previous byte began, or the address was acknowledged.
+      unsigned long const bits = index == 0 ? 1 : 9;
+      bool const garbled = emulator().clock - byte_at < bits * min_bit_cycles;
+      uint8_t const sent = garbled ? uint8_t(last_bit << 7 | b >> 1) : b;
+      byte_at = emulator().clock;
+      last_bit = b & 1;
+      ++index;
+      return sent;
+    }
+
+  private:
+    Trace const trace;
+    uint8_t const addr;
+    unsigned long ordered_at; // emulator clock
+    uint32_t sample;
+    uint8_t index;            // of the next byte read
+    unsigned long byte_at;    // emulator clock when the previous byte began
+    bool last_bit;            // of the previous byte
+};
+
+}
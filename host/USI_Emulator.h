@@ -0,0 +1,668 @@
+#pragma once
+#include <stdint.h>
+#include <vector>
+
+/*****************************************************************************
+  Host-side emulation of the ATtiny85 USI peripheral in two-wire mode and of
+  the I2C bus it drives, so that the templated code in USI_TWI_Master.hpp
+  runs unchanged on a PC. More buses can be attached to other pins of port B,
+  driven as open-drain GPIO, e.g. by BitBang_TWI_Bus.
+
+  Interrupts are taken as time passes: the Timer1 compare match A interrupt
+  (with Timer1 counting CPU cycles) and the USI counter overflow interrupt,
+  if enabled and the sketch defines their handlers with ISR(). They arrive
+  before a register access, or during delays and sleep, never within a
+  read-modify-write.
+
+  Timer0, with which the Arduino core keeps millis(), counts the system clock,
+  which clock_prescale_set() may divide, and stands still in power-down
+  (see avr/power.h and avr/sleep.h). The cycles of the CPU awake count as
+  at full speed, whatever the prescaler.
+
+  Estimated cycles count 1 cycle per I/O register read or write, 2 cycles
+  per read-modify-write (sbi/cbi) and the exact USI_TWI_Delay waits. That
+  ignores the surrounding instructions, so it's a lower bound, but one that
+  moves whenever the bus code or the Device timing changes.
+****************************************************************************/
+
+// Interrupt handlers, if the sketch defines them with ISR().
+extern "C" void TIMER1_COMPA_vect() __attribute__((weak));
+extern "C" void USI_OVF_vect() __attribute__((weak));
+
+namespace host {
+
+// Traffic and cost of one transaction (from START to STOP) or of a whole run.
+struct BusStats {
+  uint8_t address;             // 7-bit address of the last transaction, if any
+  unsigned long starts;        // START conditions, including repeated ones
+  unsigned long scl_edges;     // rising SCL edges
+  unsigned long bytes;         // bytes clocked through, including addresses
+  unsigned long delay_cycles;  // cycles spent in USI_TWI_Delay::wait
+  unsigned long cycles;        // estimated cycles, including delay_cycles
+
+  BusStats() : address(0), starts(0), scl_edges(0), bytes(0), delay_cycles(0), cycles(0) {}
+
+  BusStats& operator+=(BusStats const& other) {
+    address = other.address;
+    starts += other.starts;
+    scl_edges += other.scl_edges;
+    bytes += other.bytes;
+    delay_cycles += other.delay_cycles;
+    cycles += other.cycles;
+    return *this;
+  }
+};
+
+// An I2C slave device attached to the emulated bus.
+class Slave {
+  public:
+    virtual ~Slave() {}
+    // The 7-bit address it listens to.
+    virtual uint8_t address() const = 0;
+    // Addressed after a (repeated) START; return whether to acknowledge.
+    virtual bool select(bool reading) {
+      (void) reading;
+      return true;
+    }
+    // Receive one byte; return whether to acknowledge.
+    virtual bool write(uint8_t) {
+      return true;
+    }
+    // Supply one byte to the master.
+    virtual uint8_t read() {
+      return 0xFF;
+    }
+    // End of the transaction, by STOP or repeated START.
+    virtual void stop() {}
+};
+
+enum IoRegister : uint8_t {
+  USISR_IO, USIDR_IO, USICR_IO, PORTB_IO, DDRB_IO, PINB_IO,
+  // Registers that merely store what's written.
+  SREG_IO, TCCR1_IO, TCNT1_IO, OCR1A_IO, OCR1C_IO, TIMSK_IO, TIFR_IO, GTCCR_IO,
+  WDTCR_IO, MCUSR_IO, ADCSRA_IO,
+  IO_REGISTERS
+};
+
+// Proxy making an emulated register look like a volatile uint8_t.
+class IoReg {
+    IoRegister const id;
+  public:
+    explicit constexpr IoReg(IoRegister id) : id(id) {}
+    operator uint8_t() const;
+    IoReg& operator=(uint8_t value);
+    IoReg& operator|=(uint8_t value);
+    IoReg& operator&=(uint8_t value);
+    IoReg& operator^=(uint8_t value);
+};
+
+class Emulator {
+  public:
+    static constexpr uint8_t SDA = 0; // PB0, the USI's
+    static constexpr uint8_t SCL = 2; // PB2, the USI's
+
+    // Register bits, as in avr/iotn85.h.
+    static constexpr uint8_t USISIF = 7, USIOIF = 6, USIPF = 5, USIDC = 4, USICNT0 = 0;
+    static constexpr uint8_t USISIE = 7, USIOIE = 6, USIWM1 = 5, USIWM0 = 4;
+    static constexpr uint8_t USICS1 = 3, USICS0 = 2, USICLK = 1, USITC = 0;
+    static constexpr uint8_t CTC1 = 7, CS10 = 0, OCIE1A = 6, OCF1A = 6, SREG_I = 7;
+    static constexpr uint8_t WDIE = 6, WDP3 = 5;
+    static constexpr unsigned long INTERRUPT_CYCLES = 8; // to enter an interrupt handler and return
+    static constexpr unsigned EEPROM_SIZE = 512;
+
+    BusStats total;                     // everything since construction or reset()
+    BusStats current;                   // the transaction in progress
+    std::vector<BusStats> transactions; // completed transactions, in order
+    unsigned long clock;                // cycles elapsed, including delay() calls
+    unsigned long slept;                // cycles of clock spent asleep
+    unsigned long idle_slept[9];        // of those, in idle mode, by log2 of the clock prescaler
+    unsigned long powered_down;         // of those, in power-down mode
+    unsigned long timer0;               // cycles of the system clock that Timer0 counted
+    uint8_t clock_shift;                // log2 of the system clock prescaler
+    uint8_t sleep_mode_set;             // as set_sleep_mode() left it
+    unsigned stretch_polls;             // let a slave hold SCL low for this many reads of PINB per clock
+    unsigned stretch_once;              // same, for the next clock only, e.g. to provoke a timeout
+    uint8_t eeprom[EEPROM_SIZE];        // erased on construction, kept by reset()
+    unsigned long eeprom_writes;        // bytes of eeprom changed since construction
+    unsigned long interrupts_taken;     // since construction or reset()
+
+    Emulator() : eeprom_writes(0), buses(1, Bus(SDA, SCL)) {
+      for (uint8_t& b : eeprom) b = 0xFF;
+      reset();
+    }
+
+    // Forget all traffic and return to power-on state (slaves remain attached).
+    void reset() {
+      usisr_flags = usidr = usicr = portb = ddrb = 0;
+      for (uint8_t& reg : plain) reg = 0;
+      counter = 0;
+      latch = true;
+      for (Bus& bus : buses) bus.reset();
+      stretch_polls = stretch_once = 0;
+      stopped = false;
+      interrupts = true; // as the Arduino core leaves them
+      in_interrupt = false;
+      interrupts_taken = 0;
+      total = current = BusStats();
+      transactions.clear();
+      clock = slept = powered_down = timer0 = 0;
+      for (unsigned long& cycles : idle_slept) cycles = 0;
+      clock_shift = sleep_mode_set = 0;
+      timer0_residue = 0;
+      timer1_due = 0;
+    }
+
+    // Attach a slave to the bus on the USI's pins.
+    void attach(Slave& slave) {
+      attach(slave, SDA, SCL);
+    }
+
+    // Attach a slave to the bus on other pins of port B, with a pull-up on each.
+    void attach(Slave& slave, uint8_t sda_pin, uint8_t scl_pin) {
+      for (Bus& bus : buses) {
+        if (bus.sda_pin == sda_pin && bus.scl_pin == scl_pin) {
+          bus.slaves.push_back(&slave);
+          return;
+        }
+      }
+      buses.push_back(Bus(sda_pin, scl_pin));
+      buses.back().slaves.push_back(&slave);
+    }
+
+    void spend(unsigned long cycles) {
+      current.cycles += cycles;
+      pass(cycles);
+    }
+
+    void delay_cycles(unsigned long cycles) {
+      while (cycles != 0) {
+        unsigned long const step = until_interrupt(cycles);
+        current.delay_cycles += step;
+        spend(step);
+        cycles -= step;
+        take_interrupts();
+      }
+    }
+
+    // Time passing without bus activity, e.g. in delay().
+    void idle_cycles(unsigned long cycles) {
+      while (cycles != 0) {
+        unsigned long const step = until_interrupt(cycles);
+        pass(step);
+        cycles -= step;
+        take_interrupts();
+      }
+    }
+
+    // Time passing with the CPU asleep in idle mode.
+    void sleep_cycles(unsigned long cycles) {
+      slept += cycles;
+      idle_slept[clock_shift] += cycles;
+      pass(cycles);
+      take_interrupts();
+    }
+
+    // Time passing in power-down, with the clocks stopped, until the watchdog
+    // interrupt wakes the CPU, which then takes start_up cycles to run again.
+    void power_down(unsigned long cycles, void (*watchdog)(), unsigned long start_up) {
+      slept += cycles;
+      powered_down += cycles;
+      clock += cycles;
+      idle_cycles(start_up);
+      if (interrupts && !in_interrupt && watchdog) interrupt(watchdog);
+    }
+
+    // Cycles until the CPU asleep wakes up by an interrupt, at most cycles.
+    unsigned long until_interrupt(unsigned long cycles) const {
+      if (!interrupts || in_interrupt || !timer1_interrupting()) return cycles;
+      unsigned long const due = timer1_due > clock ? timer1_due - clock : 1;
+      return due < cycles ? due : cycles;
+    }
+
+    // The I flag of SREG, as set by sei() and cleared by cli().
+    void set_interrupts(bool enabled) {
+      interrupts = enabled;
+      take_interrupts();
+    }
+
+    uint8_t read(IoRegister id) {
+      take_interrupts();
+      spend(1);
+      if (id == PINB_IO) {
+        for (Bus& bus : buses) {
+          if (bus.stretching && --bus.stretching == 0) update_lines();
+        }
+      }
+      return peek(id);
+    }
+
+    void write(IoRegister id, uint8_t value) {
+      take_interrupts();
+      spend(1);
+      store(id, value);
+    }
+
+    // Write without cost and without taking interrupts first, to complete a read-modify-write.
+    void store(IoRegister id, uint8_t value) {
+      switch (id) {
+        case USISR_IO:
+          usisr_flags &= ~(value & (1 << USISIF | 1 << USIOIF | 1 << USIPF));
+          counter = value & 0xF;
+          break;
+        case USIDR_IO:
+          usidr = value;
+          break;
+        case USICR_IO:
+          usicr = value & ~(1 << USITC | 1 << USICLK);
+          if (value & (1 << USITC)) {
+            portb ^= 1 << SCL;
+          }
+          if ((value & (1 << USITC)) && (value & (1 << USICLK)) && (value & (1 << USICS1)) && !(value & (1 << USICS0))) {
+            // Software clock strobe feeds the counter; the shift register follows the SCL pin.
+            counter = (counter + 1) & 0xF;
+            if (counter == 0) usisr_flags |= 1 << USIOIF;
+          }
+          break;
+        case PORTB_IO:
+          portb = value;
+          break;
+        case DDRB_IO:
+          ddrb = value;
+          break;
+        case PINB_IO:
+          portb ^= value; // writing PINx toggles PORTx
+          break;
+        case SREG_IO:
+          interrupts = value & (1 << SREG_I);
+          break;
+        case TIFR_IO:
+          plain[id - SREG_IO] &= ~value; // writing a one clears a flag
+          break;
+        case TCCR1_IO:
+        case TCNT1_IO:
+        case OCR1A_IO:
+          plain[id - SREG_IO] = value;
+          restart_timer1();
+          break;
+        default:
+          plain[id - SREG_IO] = value;
+          break;
+      }
+      update_lines();
+    }
+
+    // Register value without side effects or cost, for read-modify-write.
+    uint8_t peek(IoRegister id) const {
+      switch (id) {
+        case USISR_IO: return usisr_flags | data_collision() << USIDC | counter << USICNT0;
+        case USIDR_IO: return usidr;
+        case USICR_IO: return usicr;
+        case PORTB_IO: return portb;
+        case DDRB_IO: return ddrb;
+        case PINB_IO: {
+          uint8_t pins = portb;
+          for (Bus const& bus : buses) {
+            pins = uint8_t((pins & ~(1 << bus.sda_pin | 1 << bus.scl_pin)) | bus.sda << bus.sda_pin | bus.scl << bus.scl_pin);
+          }
+          return pins;
+        }
+        case SREG_IO: return uint8_t(interrupts << SREG_I);
+        case TCNT1_IO: return timer1_count();
+        default: return plain[id - SREG_IO];
+      }
+    }
+
+    // Close the last transaction if it ended with a STOP, so that its stats are complete.
+    void flush() {
+      if (stopped) finish_transaction();
+    }
+
+    bool overflow_interrupt_pending() const {
+      return (usicr & (1 << USIOIE)) && (usisr_flags & (1 << USIOIF));
+    }
+
+    // Take the interrupts that are pending, in order of their vectors, unless disabled.
+    void take_interrupts() {
+      update_timer1();
+      if (!interrupts || in_interrupt) return;
+      for (;;) {
+        if ((reg(TIMSK_IO) & (1 << OCIE1A)) && (reg(TIFR_IO) & (1 << OCF1A)) && TIMER1_COMPA_vect) {
+          reg(TIFR_IO) &= ~(1 << OCF1A); // cleared by taking the interrupt
+          interrupt(TIMER1_COMPA_vect);
+        } else if (overflow_interrupt_pending() && USI_OVF_vect) {
+          interrupt(USI_OVF_vect);
+        } else {
+          return;
+        }
+      }
+    }
+
+  private:
+    enum State : uint8_t { IDLE, ADDRESS, ADDRESS_ACK, WRITING, WRITE_ACK, READING, READ_ACK, IGNORING };
+
+    // The lines of one bus and the protocol state of its slaves.
+    struct Bus {
+      uint8_t sda_pin, scl_pin;
+      std::vector<Slave*> slaves;
+      bool scl, sda;     // line levels
+      State state;
+      uint8_t shifter, bits;
+      bool reading;
+      bool master_acked;
+      Slave* selected;
+      bool slave_sda;
+      unsigned stretching;
+      bool stretch_armed;
+
+      Bus(uint8_t sda_pin, uint8_t scl_pin) : sda_pin(sda_pin), scl_pin(scl_pin) {
+        reset();
+      }
+
+      void reset() {
+        scl = sda = true;
+        state = IDLE;
+        shifter = bits = 0;
+        reading = master_acked = false;
+        selected = nullptr;
+        slave_sda = true;
+        stretching = 0;
+        stretch_armed = false;
+      }
+    };
+
+    uint8_t usisr_flags, usidr, usicr, portb, ddrb;
+    uint8_t plain[IO_REGISTERS - SREG_IO];
+    uint8_t counter;
+    bool latch;              // USIDR bit 7 as last seen by the output latch
+    std::vector<Bus> buses;  // the first one on the USI's pins
+    bool stopped;            // the current transaction ended, but its trailing cycles still count
+    bool interrupts;         // globally enabled
+    bool in_interrupt;
+    unsigned long timer1_due; // clock of the next compare match A, if Timer1 runs
+    unsigned long timer0_residue; // cycles of clock short of the next cycle of the system clock
+
+    // Time passing with the system clock running.
+    void pass(unsigned long cycles) {
+      clock += cycles;
+      timer0_residue += cycles;
+      timer0 += timer0_residue >> clock_shift;
+      timer0_residue &= (1ul << clock_shift) - 1;
+    }
+
+    uint8_t& reg(IoRegister id) {
+      return plain[id - SREG_IO];
+    }
+
+    uint8_t reg(IoRegister id) const {
+      return plain[id - SREG_IO];
+    }
+
+    // Timer1 counts CPU cycles from 0 to OCR1C (if CTC1), matching OCR1A on the way.
+    bool timer1_running() const {
+      return (reg(TCCR1_IO) & 0x0F) == (1 << CS10);
+    }
+
+    bool timer1_interrupting() const {
+      return timer1_running() && (reg(TIMSK_IO) & (1 << OCIE1A));
+    }
+
+    unsigned long timer1_period() const {
+      return (reg(TCCR1_IO) & (1 << CTC1)) ? reg(OCR1C_IO) + 1ul : 256ul;
+    }
+
+    uint8_t timer1_count() const {
+      if (!timer1_running()) return reg(TCNT1_IO);
+      unsigned long const period = timer1_period();
+      return uint8_t((reg(OCR1A_IO) + period - (timer1_due - clock) % period) % period);
+    }
+
+    // Count on from TCNT1, matching OCR1A when it gets there.
+    void restart_timer1() {
+      unsigned long const period = timer1_period();
+      unsigned long const until_match = (reg(OCR1A_IO) + period - reg(TCNT1_IO)) % period;
+      timer1_due = clock + (until_match ? until_match : period);
+    }
+
+    // Raise the compare match flag for every match that passed.
+    void update_timer1() {
+      if (!timer1_running()) return;
+      while (clock >= timer1_due) {
+        reg(TIFR_IO) |= 1 << OCF1A;
+        timer1_due += timer1_period();
+      }
+    }
+
+    void interrupt(void (*handler)()) {
+      ++interrupts_taken;
+      in_interrupt = true;
+      interrupts = false;
+      spend(INTERRUPT_CYCLES);
+      handler();
+      interrupts = true;
+      in_interrupt = false;
+      update_timer1();
+    }
+
+    bool usi_bus(Bus const& bus) const {
+      return &bus == &buses[0];
+    }
+
+    // Whether the pin doesn't pull its line low, as an input or an output set high.
+    bool released(uint8_t pin) const {
+      return !(ddrb & (1 << pin)) || (portb & (1 << pin));
+    }
+
+    bool master_sda(Bus const& bus) const {
+      if (usi_bus(bus) && (usicr & (1 << USIWM1))) {
+        if (!(ddrb & (1 << SDA))) return true;
+        bool const out = bus.scl ? latch : (usidr & 0x80) != 0; // latch is transparent while SCL is low
+        return (portb & (1 << SDA)) && out;
+      }
+      return released(bus.sda_pin);
+    }
+
+    bool master_scl(Bus const& bus) const {
+      return released(bus.scl_pin);
+    }
+
+    bool data_collision() const {
+      return ((usidr & 0x80) != 0) != buses[0].sda;
+    }
+
+    void update_lines() {
+      for (Bus& bus : buses) {
+        update_lines(bus);
+      }
+    }
+
+    void update_lines(Bus& bus) {
+      // Settle, since the slave may react to an edge by driving SDA.
+      for (int round = 0; round < 4; ++round) {
+        bool const want_scl = master_scl(bus);
+        if (want_scl && !bus.scl && (stretch_polls || stretch_once) && bus.state != IDLE && !bus.stretch_armed) {
+          bus.stretching = stretch_once ? stretch_once : stretch_polls;
+          stretch_once = 0;
+          bus.stretch_armed = true;
+        }
+        bool const new_scl = want_scl && !bus.stretching;
+        bool const new_sda = master_sda(bus) && bus.slave_sda;
+        if (new_scl == bus.scl && new_sda == bus.sda) return;
+        if (new_scl != bus.scl) {
+          if (new_scl) {
+            if (usi_bus(bus)) latch = (usidr & 0x80) != 0;
+            bus.scl = true;
+            bus.sda = new_sda;
+            rising_edge(bus);
+          } else {
+            bus.scl = false;
+            bus.sda = new_sda;
+            falling_edge(bus);
+          }
+        } else {
+          bus.sda = new_sda;
+          if (bus.scl) {
+            if (bus.sda) stop_condition(bus); else start_condition(bus);
+          }
+        }
+      }
+    }
+
+    void rising_edge(Bus& bus) {
+      ++current.scl_edges;
+      if (usi_bus(bus) && (usicr & (1 << USICS1))) {
+        usidr = uint8_t(usidr << 1 | bus.sda); // external positive edge clocks the shift register
+      }
+      switch (bus.state) {
+        case ADDRESS:
+        case WRITING:
+          bus.shifter = uint8_t(bus.shifter << 1 | bus.sda);
+          ++bus.bits;
+          break;
+        case READING:
+          ++bus.bits;
+          break;
+        case READ_ACK:
+          bus.master_acked = !bus.sda;
+          break;
+        default:
+          break;
+      }
+    }
+
+    void falling_edge(Bus& bus) {
+      bus.stretch_armed = false;
+      switch (bus.state) {
+        case ADDRESS:
+          if (bus.bits == 8) {
+            ++current.bytes;
+            bus.reading = bus.shifter & 1;
+            current.address = bus.shifter >> 1;
+            bus.selected = nullptr;
+            for (Slave* slave : bus.slaves) {
+              if (slave->address() == bus.shifter >> 1) bus.selected = slave;
+            }
+            if (bus.selected && bus.selected->select(bus.reading)) {
+              bus.slave_sda = false;
+              bus.state = ADDRESS_ACK;
+            } else {
+              bus.selected = nullptr;
+              bus.state = IGNORING;
+            }
+          }
+          break;
+        case ADDRESS_ACK:
+          if (bus.reading) {
+            start_reading(bus);
+          } else {
+            bus.slave_sda = true;
+            bus.bits = 0;
+            bus.state = WRITING;
+          }
+          break;
+        case WRITING:
+          if (bus.bits == 8) {
+            ++current.bytes;
+            bus.slave_sda = !bus.selected->write(bus.shifter);
+            bus.state = WRITE_ACK;
+          }
+          break;
+        case WRITE_ACK:
+          bus.slave_sda = true;
+          bus.bits = 0;
+          bus.state = WRITING;
+          break;
+        case READING:
+          if (bus.bits == 8) {
+            ++current.bytes;
+            bus.slave_sda = true;
+            bus.state = READ_ACK;
+          } else {
+            bus.slave_sda = (bus.shifter << bus.bits & 0x80) != 0;
+          }
+          break;
+        case READ_ACK:
+          if (bus.master_acked) {
+            start_reading(bus);
+          } else {
+            bus.state = IGNORING;
+          }
+          break;
+        default:
+          break;
+      }
+    }
+
+    void start_reading(Bus& bus) {
+      bus.shifter = bus.selected->read();
+      bus.bits = 0;
+      bus.slave_sda = (bus.shifter & 0x80) != 0;
+      bus.state = READING;
+    }
+
+    void start_condition(Bus& bus) {
+      if (usi_bus(bus)) usisr_flags |= 1 << USISIF;
+      if (bus.selected) bus.selected->stop();
+      flush(); // a repeated START continues the same transaction
+      ++current.starts;
+      bus.selected = nullptr;
+      bus.slave_sda = true;
+      bus.shifter = bus.bits = 0;
+      bus.state = ADDRESS;
+    }
+
+    void stop_condition(Bus& bus) {
+      if (usi_bus(bus)) usisr_flags |= 1 << USIPF;
+      if (bus.selected) bus.selected->stop();
+      bus.selected = nullptr;
+      bus.slave_sda = true;
+      stopped = bus.state != IDLE;
+      bus.state = IDLE;
+    }
+
+    void finish_transaction() {
+      stopped = false;
+      transactions.push_back(current);
+      total += current;
+      current = BusStats();
+    }
+};
+
+inline Emulator& emulator() {
+  static Emulator instance;
+  return instance;
+}
+
+inline IoReg::operator uint8_t() const {
+  return emulator().read(id);
+}
+
+inline IoReg& IoReg::operator=(uint8_t value) {
+  emulator().write(id, value);
+  return *this;
+}
+
+inline IoReg& IoReg::operator|=(uint8_t value) {
+  Emulator& emu = emulator();
+  emu.take_interrupts();
+  emu.spend(2); // sbi/cbi take 2 cycles
+  emu.store(id, uint8_t(emu.peek(id) | value));
+  return *this;
+}
+
+inline IoReg& IoReg::operator&=(uint8_t value) {
+  Emulator& emu = emulator();
+  emu.take_interrupts();
+  emu.spend(2);
+  emu.store(id, uint8_t(emu.peek(id) & value));
+  return *this;
+}
+
+inline IoReg& IoReg::operator^=(uint8_t value) {
+  Emulator& emu = emulator();
+  emu.take_interrupts();
+  emu.spend(2);
+  emu.store(id, uint8_t(emu.peek(id) ^ value));
+  return *this;
+}
+
+}
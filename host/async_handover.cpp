@@ -0,0 +1,124 @@
+#include "ATtiny85_OLED_USDS.ino"
+#include "SSD1306_Model.h"
+#include "USDS_Model.h"
+#include <stdio.h>
+
+/*****************************************************************************
+  Checks that USI_TWI_Async_Bus takes the USI back cleanly from the blocking
+  code. A read that the sensor doesn't acknowledge, while it's ranging, ends
+  without a STOP condition and with SCL held low, either on USI_TWI_Bus or
+  lent out by the engine. The display's next frame must still start right
+  away, as after a frame of its own, rather than wait for SCL until the
+  timeout and recover the bus. Before that, it checks that stop() returns
+  while the frame is still going out, and I2C::result() once it's over.
+  Build and run from the sketch's directory:
+
+    g++ -std=gnu++17 -DUSI_TWI_ASYNC=1 -Ihost -I. -x c++ host/async_handover.cpp -x none *.cpp -o async_handover
+    ./async_handover
+****************************************************************************/
+
+#if !USI_TWI_ASYNC
+#error "build with -DUSI_TWI_ASYNC=1"
+#endif
+
+using Panel = OLED_PANEL<0x3C>;
+using Sensor = USDS_DEVICE<0x57>;
+
+// The sensor read through the engine, which lends the USI to the blocking code.
+struct LentSensor : Sensor {
+  using Bus = USI_TWI_Async_Bus;
+};
+
+static host::SSD1306_Model oled;
+
+static uint32_t standing(unsigned long) {
+  return 800000;
+}
+
+struct Frame {
+  I2C::Status status;
+  unsigned long cycles;
+};
+
+// A few columns to the display, as a frame of its own, until it's over.
+static Frame frame() {
+  host::Emulator& emu = host::emulator();
+  unsigned long const clock = emu.clock;
+  I2C::Status const status = finished<Panel>(OLED::Chat<Panel> {0}
+                                             .set_column_address(0, 7)
+                                             .set_page_address(0, 0)
+                                             .start_data()
+                                             .sendN(8, 0xFF)
+                                             .stop());
+  return Frame{status, emu.clock - clock};
+}
+
+// Have the sensor range, and read it too early.
+template <typename Device>
+static USI_TWI_ErrorLevel read_too_early() {
+  byte buf[3];
+  I2C::Status const ordered = I2C::Chat<Sensor> {0}.send(0x01).stop();
+  if (ordered.error) return USI_TWI_ErrorLevel(ordered.error);
+  return I2C::receive<Device>(buf, sizeof buf);
+}
+
+template <typename Device>
+static bool check(char const* name, Frame const& reference) {
+  USI_TWI_ErrorLevel const read = read_too_early<Device>();
+  Frame const after = frame();
+  if (read != USI_TWI_NO_ACK_ON_ADDRESS) {
+    printf("%s: read ended with error %u rather than not acknowledged\n", name, read);
+    return false;
+  }
+  if (after.status.error || after.cycles > reference.cycles + 2 * USI_TWI_ASYNC_MIN_HALF_PERIOD) {
+    printf("%s: frame after error %u at %u, in %lu cycles, rather than %lu\n", name,
+           after.status.error, after.status.location, after.cycles, reference.cycles);
+    return false;
+  }
+  printf("%s ok\n", name);
+  return true;
+}
+
+// The frame goes out after stop() returned, and I2C::result() waits for it.
+static bool check_queued(Frame const& reference) {
+  host::Emulator& emu = host::emulator();
+  oled.take_frame();
+  unsigned long const clock = emu.clock;
+  I2C::Status const stopped = OLED::Chat<Panel> {0}
+                              .set_column_address(0, 7)
+                              .set_page_address(0, 0)
+                              .start_data()
+                              .sendN(8, 0xFF)
+                              .stop();
+  unsigned long const queued = emu.clock - clock;
+  bool const pending = I2C::pending<Panel>();
+  USI_TWI_ErrorLevel const result = I2C::result<Panel>();
+  unsigned long const bytes = oled.take_frame().bytes();
+  if (stopped.error || !pending || queued >= reference.cycles / 2 || result || bytes == 0) {
+    printf("queued: stopped with error %u after %lu cycles of %lu, %s, then error %u and %lu bytes\n",
+           stopped.error, queued, reference.cycles, pending ? "pending" : "not pending", result, bytes);
+    return false;
+  }
+  printf("queued ok\n");
+  return true;
+}
+
+int main() {
+  host::Emulator& emu = host::emulator();
+  host::USDS_Model usds(standing);
+  emu.attach(oled);
+  emu.attach(usds);
+  I2C::BusOf<Sensor>::type::Initialise();
+  I2C::BusOf<Panel>::type::Initialise();
+  frame();
+  Frame const reference = frame();
+  if (reference.status.error) {
+    printf("no display\n");
+    return 1;
+  }
+  int failed = 0;
+  failed += !check_queued(reference);
+  failed += !check<Sensor>("blocking", reference);
+  failed += !check<LentSensor>("lent", reference);
+  return failed;
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include "../USI_Emulator.h"
+
+// Host stand-in for <avr/eeprom.h>: the emulator's EEPROM, which reset() leaves alone.
+
+inline uint8_t eeprom_read_byte(uint8_t const* addr) {
+  return ::host::emulator().eeprom[reinterpret_cast<uintptr_t>(addr) % ::host::Emulator::EEPROM_SIZE];
+}
+
+inline void eeprom_update_byte(uint8_t* addr, uint8_t value) {
+  uint8_t& stored = ::host::emulator().eeprom[reinterpret_cast<uintptr_t>(addr) % ::host::Emulator::EEPROM_SIZE];
+  if (stored != value) {
+    stored = value;
+    ++::host::emulator().eeprom_writes;
+  }
+}
+
+// Writes take no time on the host.
+inline bool eeprom_is_ready() {
+  return true;
+}
+
+inline void eeprom_read_block(void* dst, void const* src, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    static_cast<uint8_t*>(dst)[i] = eeprom_read_byte(static_cast<uint8_t const*>(src) + i);
+  }
+}
+
+inline void eeprom_update_block(void const* src, void* dst, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    eeprom_update_byte(static_cast<uint8_t*>(dst) + i, static_cast<uint8_t const*>(src)[i]);
+  }
+}
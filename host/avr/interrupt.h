@@ -0,0 +1,9 @@
+#pragma once
+#include "../USI_Emulator.h"
+
+// Host stand-in for <avr/interrupt.h>: the emulator calls the handlers of the
+// interrupts it knows (see USI_Emulator.h) when they're due and enabled.
+
+#define sei() (::host::emulator().set_interrupts(true))
+#define cli() (::host::emulator().set_interrupts(false))
+#define ISR(vector, ...) extern "C" void vector()
@@ -0,0 +1,75 @@
+#pragma once
+#include "../USI_Emulator.h"
+
+// Host stand-in for <avr/io.h>: the registers used by this sketch, as an ATtiny85.
+
+#ifndef F_CPU
+#define F_CPU 16500000UL
+#endif
+
+#ifndef __AVR_ATtiny85__
+#define __AVR_ATtiny85__
+#endif
+
+#define E2END (::host::Emulator::EEPROM_SIZE - 1)
+
+#define __builtin_avr_delay_cycles(n) (::host::emulator().delay_cycles(n))
+
+#define USISR (::host::IoReg(::host::USISR_IO))
+#define USIDR (::host::IoReg(::host::USIDR_IO))
+#define USICR (::host::IoReg(::host::USICR_IO))
+#define PORTB (::host::IoReg(::host::PORTB_IO))
+#define DDRB (::host::IoReg(::host::DDRB_IO))
+#define PINB (::host::IoReg(::host::PINB_IO))
+#define SREG (::host::IoReg(::host::SREG_IO))
+#define TCCR1 (::host::IoReg(::host::TCCR1_IO))
+#define TCNT1 (::host::IoReg(::host::TCNT1_IO))
+#define OCR1A (::host::IoReg(::host::OCR1A_IO))
+#define OCR1C (::host::IoReg(::host::OCR1C_IO))
+#define TIMSK (::host::IoReg(::host::TIMSK_IO))
+#define TIFR (::host::IoReg(::host::TIFR_IO))
+#define GTCCR (::host::IoReg(::host::GTCCR_IO))
+#define WDTCR (::host::IoReg(::host::WDTCR_IO))
+#define MCUSR (::host::IoReg(::host::MCUSR_IO))
+#define ADCSRA (::host::IoReg(::host::ADCSRA_IO))
+
+#define USISIF 7
+#define USIOIF 6
+#define USIPF 5
+#define USIDC 4
+#define USICNT0 0
+#define USISIE 7
+#define USIOIE 6
+#define USIWM1 5
+#define USIWM0 4
+#define USICS1 3
+#define USICS0 2
+#define USICLK 1
+#define USITC 0
+
+#define CTC1 7
+#define CS10 0
+#define OCIE1A 6
+#define OCF1A 6
+#define PSR1 1
+
+#define WDIF 7
+#define WDIE 6
+#define WDP3 5
+#define WDCE 4
+#define WDE 3
+#define WDP2 2
+#define WDP1 1
+#define WDP0 0
+#define WDRF 3
+
+#define PORTB0 0
+#define PORTB1 1
+#define PORTB2 2
+#define PORTB3 3
+#define PORTB4 4
+#define PINB0 0
+#define PINB1 1
+#define PINB2 2
+#define PINB3 3
+#define PINB4 4
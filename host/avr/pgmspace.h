@@ -0,0 +1,25 @@
+#pragma once
+#include <stdint.h>
+#include <string.h>
+#include "../AvrCycles.h"
+
+// Host stand-in for <avr/pgmspace.h>: flash is just memory, but each read
+// charges host::avr_cycles() the 3 cycles of an LPM per byte.
+
+namespace host {
+
+template <typename T>
+T pgm_read(void const* addr) {
+  avr_cycles() += 3 * sizeof(T);
+  T value;
+  memcpy(&value, addr, sizeof value);
+  return value;
+}
+
+}
+
+#define PROGMEM
+#define PSTR(s) (s)
+#define pgm_read_byte(addr) (host::pgm_read<uint8_t>(addr))
+#define pgm_read_word(addr) (host::pgm_read<uint16_t>(addr))
+#define memcpy_P memcpy
@@ -0,0 +1,23 @@
+#pragma once
+#include "../USI_Emulator.h"
+
+// Host stand-in for <avr/power.h>: the system clock prescaler, which slows Timer0
+// (see USI_Emulator.h), and the power reduction of the unused ADC, which doesn't matter.
+
+typedef enum {
+  clock_div_1 = 0,
+  clock_div_2 = 1,
+  clock_div_4 = 2,
+  clock_div_8 = 3,
+  clock_div_16 = 4,
+  clock_div_32 = 5,
+  clock_div_64 = 6,
+  clock_div_128 = 7,
+  clock_div_256 = 8
+} clock_div_t;
+
+inline void clock_prescale_set(clock_div_t div) {
+  ::host::emulator().clock_shift = uint8_t(div);
+}
+
+inline void power_adc_disable() {}
@@ -0,0 +1,49 @@
+#pragma once
+#include <stdio.h>
+#include <stdlib.h>
+#include "io.h"
+
+// Host stand-in for <avr/sleep.h>. In idle mode, sleep lasts until the next
+// Timer0 overflow interrupt, with which the Arduino core keeps time every 64 * 256
+// cycles of the system clock, or until an interrupt that the emulator takes comes
+// first. In power-down, the clocks stop until the watchdog interrupt, which must
+// be enabled, after 16 ms times 2 to the power of its prescaler bits, as its
+// oscillator would take at exactly 128 kHz. The CPU then takes 1K cycles to
+// start up, as with the Digispark's fuses (SUT of the PLL clock).
+
+#define SLEEP_MODE_IDLE 0
+#define SLEEP_MODE_ADC 1
+#define SLEEP_MODE_PWR_DOWN 2
+
+extern "C" void WDT_vect() __attribute__((weak));
+
+inline void set_sleep_mode(uint8_t mode) {
+  ::host::emulator().sleep_mode_set = mode;
+}
+
+inline void sleep_enable() {}
+inline void sleep_disable() {}
+inline void sleep_bod_disable() {}
+
+inline void sleep_cpu() {
+  ::host::Emulator& emu = ::host::emulator();
+  if (emu.sleep_mode_set == SLEEP_MODE_PWR_DOWN) {
+    uint8_t const wdtcr = emu.peek(::host::WDTCR_IO);
+    if (!(wdtcr & (1 << WDIE))) {
+      fprintf(stderr, "powered down for good\n");
+      abort();
+    }
+    uint8_t const prescaler = (wdtcr & 7) | (wdtcr >> WDP3 & 1) << 3;
+    emu.power_down((F_CPU / 1000) * (16ul << prescaler), WDT_vect, 1024);
+  } else {
+    unsigned long constexpr TIMER0_OVERFLOW = 64UL * 256;
+    unsigned long const ticks = TIMER0_OVERFLOW - emu.timer0 % TIMER0_OVERFLOW;
+    emu.sleep_cycles(emu.until_interrupt(ticks << emu.clock_shift));
+  }
+}
+
+inline void sleep_mode() {
+  sleep_enable();
+  sleep_cpu();
+  sleep_disable();
+}
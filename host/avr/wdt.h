@@ -0,0 +1,6 @@
+#pragma once
+
+// Host stand-in for <avr/wdt.h>: the emulated watchdog only times power-down
+// (see avr/sleep.h), from the moment the CPU goes to sleep.
+
+inline void wdt_reset() {}
@@ -0,0 +1,64 @@
+#include "ATtiny85_OLED_USDS.ino"
+#include "SSD1306_Model.h"
+#include "USDS_Model.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/*****************************************************************************
+  Runs the sketch on the emulated bus, with a display and a sensor attached,
+  and prints every transaction of the first few samples: address, (repeated)
+  STARTs, SCL edges, bytes, and estimated cycles, of which delay cycles.
+  Build and run from the sketch's directory, e.g. for 5 samples:
+
+    g++ -std=gnu++17 -Ihost -I. -x c++ host/bus_report.cpp -x none *.cpp -o bus_report
+    ./bus_report 5
+****************************************************************************/
+
+// A person walking up to the sensor.
+static uint32_t approaching(unsigned long n) {
+  return n < 200 ? 1500000 - 5000 * n : 500000;
+}
+
+static void print(char const* what, host::BusStats const& stats) {
+  printf("%-12s %02X %6lu %8lu %6lu %9lu %9lu\n", what, stats.address, stats.starts,
+         stats.scl_edges, stats.bytes, stats.delay_cycles, stats.cycles);
+}
+
+int main(int argc, char** argv) {
+  unsigned long const samples = argc > 1 ? strtoul(argv[1], nullptr, 10) : 3;
+  host::Emulator& emu = host::emulator();
+  host::SSD1306_Model oled;
+  host::USDS_Model usds(approaching);
+  emu.attach(oled);
+  emu.attach(usds);
+
+  printf("%-12s %-2s %6s %8s %6s %9s %9s\n", "", "to", "starts", "edges", "bytes", "delays", "cycles");
+  setup();
+  emu.flush();
+  print("setup", emu.total);
+  host::BusStats const before = emu.total;
+  unsigned long const clock = emu.clock, slept = emu.slept;
+  emu.transactions.clear();
+
+  unsigned long const first = usds.orders;
+  while (usds.orders < first + samples) {
+    loop();
+    emu.flush();
+    for (host::BusStats const& transaction : emu.transactions) {
+      print("", transaction);
+    }
+    emu.transactions.clear();
+  }
+  host::BusStats loops = emu.total;
+  loops.starts -= before.starts;
+  loops.scl_edges -= before.scl_edges;
+  loops.bytes -= before.bytes;
+  loops.delay_cycles -= before.delay_cycles;
+  loops.cycles -= before.cycles;
+  print("loop", loops);
+  printf("%lu samples in %lu ms, %lu of them asleep\n", samples,
+         (emu.clock - clock) / (F_CPU / 1000), (emu.slept - slept) / (F_CPU / 1000));
+  if (emu.interrupts_taken != 0) {
+    printf("%lu interrupts taken\n", emu.interrupts_taken);
+  }
+}
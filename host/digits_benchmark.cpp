@@ -0,0 +1,199 @@
+#include "GlyphsOnQuarter.h"
+#include "AvrCycles.h"
+#include <stdio.h>
+#include <vector>
+
+/*****************************************************************************
+  Compares the digit formatters, which find digits with Digits, with the /10
+  %10 code they replaced, for every input: send3dec for 0 to 255, send4dec for
+  0 to 32767 (an int on the ATtiny85; negative numbers never reach either),
+  and the distance that displayMillimeter formats, for every reading of the
+  sensor (micrometers, 24 bits). Both must send the same cells, and it prints
+  the AVR cycles either takes to find the digits, on average and at most.
+  Build and run from the sketch's directory:
+
+    g++ -std=gnu++17 -O1 -Ihost -I. -x c++ host/digits_benchmark.cpp -x none *.cpp -o digits_benchmark
+    ./digits_benchmark
+
+  The cycles come from host::Cycles (see AvrCycles.h): libgcc's division
+  routines exactly, the shifts, logic and tests Digits does at what they take
+  on an ATtiny85, which has no MUL or DIV instruction. Sending the cells is
+  the same for both and not counted.
+****************************************************************************/
+
+using host::Cycles;
+
+template <typename T>
+using Plain = T;
+
+bool operator==(GlyphLineCell const& a, GlyphLineCell const& b) {
+  return a.key == b.key && a.width == b.width && a.margin == b.margin && a.kind == b.kind;
+}
+
+// Records the cells a formatter sends.
+class Recorder : public GlyphFormatter<Recorder, 1> {
+  public:
+    std::vector<GlyphLineCell> cells;
+
+    void sendCell(GlyphLineCell const& cell) {
+      cells.push_back(cell);
+    }
+};
+
+// The formatters as they were, dividing in integers of type W<T>.
+template <template <typename> class W>
+static void old_send3dec(Recorder& out, uint8_t number) {
+  W<uint8_t> const n(number);
+  W<uint8_t> const p1(n / 100);
+  W<uint8_t> const p2(n % 100);
+  if (p1 != 0) {
+    out.send(DigitGlyph::dec_digit[p1], Glyph::DIGIT_MARGIN);
+  } else {
+    out.send(0, Glyph::DIGIT_WIDTH);
+  }
+  if (p1 != 0 || p2 >= 10) {
+    out.send(DigitGlyph::dec_digit[p2 / 10], Glyph::DIGIT_MARGIN);
+  } else {
+    out.send(0, Glyph::DIGIT_WIDTH);
+  }
+  out.send(DigitGlyph::dec_digit[p2 % 10], Glyph::DIGIT_MARGIN);
+}
+
+template <template <typename> class W>
+static void old_send4dec(Recorder& out, int16_t number) {
+  W<int16_t> const n(number);
+  W<uint8_t> const p1(n / 100);
+  W<uint8_t> const p2(n % 100);
+  if (p1 >= 100) {
+    out.send(~0, Glyph::DIGIT_WIDTH * 4);
+    return;
+  }
+  if (p1 >= 10) {
+    out.send(DigitGlyph::dec_digit[p1 / 10], Glyph::DIGIT_MARGIN);
+  } else {
+    out.send(0, Glyph::DIGIT_WIDTH);
+  }
+  if (p1 != 0) {
+    out.send(DigitGlyph::dec_digit[p1 % 10], Glyph::DIGIT_MARGIN);
+  } else {
+    out.send(0, Glyph::DIGIT_WIDTH);
+  }
+  if (p1 != 0 || p2 >= 10) {
+    out.send(DigitGlyph::dec_digit[p2 / 10], Glyph::DIGIT_MARGIN);
+  } else {
+    out.send(0, Glyph::DIGIT_WIDTH);
+  }
+  out.send(DigitGlyph::dec_digit[p2 % 10], Glyph::DIGIT_MARGIN);
+}
+
+template <template <typename> class W>
+static void old_millimeter(Recorder& out, uint32_t micrometers) {
+  W<uint32_t> const distance(micrometers);
+  W<uint16_t> value((distance + 500) / 1000);
+  W<uint8_t> const decimal3(value % 10);
+  value /= 10;
+  W<uint8_t> const decimal2(value % 10);
+  value /= 10;
+  W<uint8_t> const decimal1(value % 10);
+  value /= 10;
+  W<uint8_t> const unit(value % 10);
+  value /= 10;
+  if (value == 0) {
+    out.send(0, Glyph::DIGIT_WIDTH);
+  } else if (value < 10) {
+    out.send(DigitGlyph::dec_digit[value], Glyph::DIGIT_MARGIN);
+  } else {
+    out.send(~0, Glyph::DIGIT_WIDTH);
+  }
+  out.send(DigitGlyph::dec_digit[unit], Glyph::DIGIT_MARGIN);
+  out.sendPoint();
+  out.send(DigitGlyph::dec_digit[decimal1], Glyph::DIGIT_MARGIN);
+  out.send(DigitGlyph::dec_digit[decimal2], Glyph::DIGIT_MARGIN);
+  out.send(DigitGlyph::dec_digit[decimal3], Glyph::DIGIT_MARGIN);
+}
+
+// Cycles that sendNumber<10, WIDTH, 0, false, DROPPED> takes to find and test the digits of number.
+template <uint8_t WIDTH, uint8_t DROPPED, typename U>
+static unsigned long digits_cycles(U number) {
+  host::avr_cycles() = 0;
+  Digits<10, DROPPED + WIDTH, Cycles<uint8_t>> const digits {Cycles<U>(number)};
+  if (digits.fits()) {
+    for (uint8_t i = WIDTH; i-- > 0;) {
+      (void)(Cycles<uint8_t>(digits[DROPPED + i]) != 0);
+    }
+  }
+  return host::avr_cycles();
+}
+
+struct Tally {
+  char const* name;
+  unsigned long inputs = 0, mismatches = 0, expected = 0;
+  unsigned long long old_total = 0, new_total = 0;
+  unsigned long old_max = 0, new_max = 0;
+
+  explicit Tally(char const* name) : name(name) {}
+
+  // Add one input, whose cells may differ only if known to be wrong in the old code.
+  void add(Recorder const& old_cells, Recorder const& new_cells, bool old_wrong,
+           unsigned long old_cycles, unsigned long new_cycles) {
+    ++inputs;
+    if (old_cells.cells != new_cells.cells) {
+      ++(old_wrong ? expected : mismatches);
+    }
+    old_total += old_cycles;
+    new_total += new_cycles;
+    old_max = old_cycles > old_max ? old_cycles : old_max;
+    new_max = new_cycles > new_max ? new_cycles : new_max;
+  }
+
+  void print() const {
+    printf("%-12s %9lu %9.1f %9lu %9.1f %9lu %9lu %9lu\n", name, inputs,
+           double(old_total) / inputs, old_max, double(new_total) / inputs, new_max,
+           expected, mismatches);
+  }
+};
+
+// The cycles that the old formatter takes for one input.
+template <typename F, typename... Args>
+static unsigned long old_cycles(F format, Args... args) {
+  Recorder ignored;
+  host::avr_cycles() = 0;
+  format(ignored, args...);
+  return host::avr_cycles();
+}
+
+int main() {
+  printf("%-12s %9s %9s %9s %9s %9s %9s %9s\n", "formatter", "inputs", "old avg", "old max",
+         "new avg", "new max", "old wrong", "different");
+
+  Tally dec3 {"send3dec"};
+  for (unsigned n = 0; n <= 0xFF; ++n) {
+    Recorder before, after;
+    old_send3dec<Plain>(before, uint8_t(n));
+    after.send3dec(uint8_t(n));
+    dec3.add(before, after, false, old_cycles(old_send3dec<Cycles>, uint8_t(n)), digits_cycles<3, 0>(uint8_t(n)));
+  }
+  dec3.print();
+
+  // Beyond 25599, the old code kept only the low byte of number / 100.
+  Tally dec4 {"send4dec"};
+  for (long n = 0; n <= 0x7FFF; ++n) {
+    Recorder before, after;
+    old_send4dec<Plain>(before, int16_t(n));
+    after.send4dec(int(n));
+    dec4.add(before, after, n / 100 > 0xFF, old_cycles(old_send4dec<Cycles>, int16_t(n)), digits_cycles<4, 0>(uint16_t(n)));
+  }
+  dec4.print();
+
+  // As displayMillimeter formats it, without the unit.
+  Tally mm {"millimeter"};
+  for (uint32_t micrometers = 0; micrometers <= 0xFFFFFF; ++micrometers) {
+    Recorder before, after;
+    old_millimeter<Plain>(before, micrometers);
+    after.sendNumber<10, 5, 3, false, 3>(micrometers + 500);
+    mm.add(before, after, false, old_cycles(old_millimeter<Cycles>, micrometers), digits_cycles<5, 3>(micrometers + 500));
+  }
+  mm.print();
+
+  return dec3.mismatches || dec4.mismatches || mm.mismatches;
+}
@@ -0,0 +1,136 @@
+#include "ATtiny85_OLED_USDS.ino"
+#include "SSD1306_Model.h"
+#include <stdio.h>
+#include <string>
+
+/*****************************************************************************
+  Compares the bus engines, sending the same frames to a display on the USI
+  (USI_TWI_Bus) and to one on two other pins (BitBang_TWI_Bus), with the
+  sketch's panel timing: a whole screen from RAM in one burst, and the
+  distance field as displayMillimeter draws it from scratch. Both displays
+  must show the same pixels. Build and run from the sketch's directory:
+
+    g++ -std=gnu++17 -DUSI_TWI_COUNTED=1 -Ihost -I. -x c++ host/engine_benchmark.cpp -x none *.cpp -o engine_benchmark
+    ./engine_benchmark
+
+  It prints the cycles per byte on the bus, in two parts: what the emulator
+  charges for register accesses and delays, and what the engines' loops
+  take to count, shift and test bits and bytes, which USI_TWI_COUNTED has
+  host::Cycles count (see AvrCycles.h), and the reads from program memory
+  for the distance field. Calls and branches on the bits
+  themselves aren't charged, so both parts are lower bounds, and they leave
+  out more of the bit-banged engine, which does per bit what the USI does
+  per byte.
+****************************************************************************/
+
+struct UsiPanel : OLED_PANEL<0x3C> {
+  using Bus = USI_TWI_Bus;
+};
+
+struct BitBangPanel : OLED_PANEL<0x3C> {
+  using Bus = BitBang_TWI_Bus<PORTB4, PORTB3>;
+};
+
+static host::SSD1306_Model usi_oled, bitbang_oled;
+
+template <typename Panel>
+static I2C::Status clear() {
+  return OLED::Chat<Panel> {0}
+  .init()
+  .set_addressing_mode(OLED::VerticalAddressing)
+  .set_column_address()
+  .set_page_address()
+  .set_enabled()
+  .start_data()
+  .sendN(OLED::BYTES, 0)
+  .stop();
+}
+
+struct Cost {
+  unsigned long bytes = 0;   // on the bus, including addresses
+  unsigned long emulated = 0; // register accesses and delays
+  unsigned long counted = 0;  // loops of the engine, from host::Cycles
+};
+
+// Run a drawing and tell what it took.
+template <typename Draw>
+static Cost measure(Draw draw) {
+  host::Emulator& emu = host::emulator();
+  emu.flush();
+  emu.transactions.clear();
+  unsigned long const clock = emu.clock;
+  host::avr_cycles() = 0;
+  I2C::Status const status = draw();
+  Cost cost;
+  cost.counted = host::avr_cycles();
+  cost.emulated = emu.clock - clock;
+  emu.flush();
+  for (host::BusStats const& transaction : emu.transactions) {
+    cost.bytes += transaction.bytes;
+  }
+  if (status.error) {
+    printf("error %u@%u\n", status.error, status.location);
+  }
+  return cost;
+}
+
+static uint8_t screen[OLED::BYTES];
+
+template <typename Panel>
+static I2C::Status draw_screen() {
+  return OLED::Chat<Panel> {0}
+  .set_column_address()
+  .set_page_address()
+  .start_data()
+  .sendBytes(screen, sizeof screen)
+  .stop();
+}
+
+template <typename Panel>
+static I2C::Status draw_distance() {
+  MillimeterLine line;
+  line.sendNumber<10, 5, 3, false, 3>(1234567ul + 500);
+  line.send(METER_LABEL);
+  GlyphCache<10> cells;
+  auto chat = Field<Panel> {10, OLED::Quarter::A, cells, 0, OLED::WIDTH - 1, OLED::Heartbeat::None};
+  chat.send(line);
+  return chat.stop();
+}
+
+static void print(char const* what, char const* engine, Cost const& cost) {
+  double const bytes = cost.bytes;
+  printf("%-10s %-9s %6lu %9.1f %9.1f %9.1f %9.2f\n", what, engine, cost.bytes,
+         cost.emulated / bytes, cost.counted / bytes, (cost.emulated + cost.counted) / bytes,
+         (cost.emulated + cost.counted) / (F_CPU / 1000.0));
+}
+
+template <I2C::Status (*Usi)(), I2C::Status (*BitBang)()>
+static bool compare(char const* what) {
+  print(what, "USI", measure(Usi));
+  print(what, "bit-bang", measure(BitBang));
+  if (usi_oled.pbm() != bitbang_oled.pbm()) {
+    printf("%s: the displays differ\n", what);
+    return false;
+  }
+  return true;
+}
+
+int main() {
+  host::Emulator& emu = host::emulator();
+  emu.attach(usi_oled);
+  emu.attach(bitbang_oled, PORTB4, PORTB3);
+  I2C::BusOf<UsiPanel>::type::Initialise();
+  I2C::BusOf<BitBangPanel>::type::Initialise();
+  if (clear<UsiPanel>().error || clear<BitBangPanel>().error) {
+    printf("no display\n");
+    return 1;
+  }
+  for (unsigned i = 0; i < sizeof screen; ++i) {
+    screen[i] = uint8_t(i * 37 + (i >> 7));
+  }
+
+  printf("%-10s %-9s %6s %9s %9s %9s %9s\n", "frame", "engine", "bytes", "emulated", "counted", "per byte", "ms");
+  bool const same = compare<draw_screen<UsiPanel>, draw_screen<BitBangPanel>>("screen")
+                    && compare<draw_distance<UsiPanel>, draw_distance<BitBangPanel>>("distance");
+  return same ? 0 : 1;
+}
@@ -0,0 +1,80 @@
+#include "ATtiny85_OLED_USDS.ino"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+
+/*****************************************************************************
+  Replays the sensor samples recorded in host/traces/NAME.txt (micrometers,
+  one per line, after comment lines starting with #) through the sketch's
+  SensorFilter, and compares the display updates it asks for with those in
+  host/traces/NAME.updates: the number of each sample that updated the
+  display, counting from 0, and the value displayed. Build and run from the
+  sketch's directory:
+
+    g++ -std=gnu++17 -Ihost -I. -x c++ host/filter_traces.cpp -x none *.cpp -o filter_traces
+    ./filter_traces
+
+  Run with --update to write the updates instead, then check them (e.g. that
+  single glitches never reach the display) before committing them.
+****************************************************************************/
+
+static std::string load(std::string const& path) {
+  std::string s;
+  if (FILE* f = fopen(path.c_str(), "r")) {
+    char buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof buf, f)) > 0) s.append(buf, n);
+    fclose(f);
+  }
+  return s;
+}
+
+// The updates the filter asks for over the samples of a trace, one line each.
+static std::string replay(std::string const& trace, unsigned& samples) {
+  SensorFilter filter;
+  std::string updates;
+  samples = 0;
+  char const* line = trace.c_str();
+  for (; *line; line = strchr(line, '\n') ? strchr(line, '\n') + 1 : line + strlen(line)) {
+    if (*line == '#' || *line == '\n') continue;
+    uint32_t const sample = uint32_t(strtoul(line, nullptr, 10));
+    if (filter.add(sample)) {
+      updates += std::to_string(samples) + " " + std::to_string(filter.value()) + "\n";
+    }
+    ++samples;
+  }
+  return updates;
+}
+
+int main(int argc, char** argv) {
+  bool const update = argc > 1 && strcmp(argv[1], "--update") == 0;
+  char const* const traces[] = { "walk_up", "still", "door", "glitches" };
+  int failed = 0;
+  for (char const* name : traces) {
+    std::string const trace = load(std::string("host/traces/") + name + ".txt");
+    if (trace.empty()) {
+      printf("%s: no samples\n", name);
+      ++failed;
+      continue;
+    }
+    unsigned samples;
+    std::string const updates = replay(trace, samples);
+    unsigned const count = unsigned(std::count(updates.begin(), updates.end(), '\n'));
+    std::string const path = std::string("host/traces/") + name + ".updates";
+    if (update) {
+      if (FILE* f = fopen(path.c_str(), "w")) {
+        fputs(updates.c_str(), f);
+        fclose(f);
+      }
+      printf("%s written, %u updates for %u samples\n", path.c_str(), count, samples);
+    } else if (updates == load(path)) {
+      printf("%s ok, %u updates for %u samples\n", name, count, samples);
+    } else {
+      printf("%s differs from %s:\n%s", name, path.c_str(), updates.c_str());
+      ++failed;
+    }
+  }
+  return failed;
+}
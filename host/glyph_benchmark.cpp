@@ -0,0 +1,99 @@
+#include "ATtiny85_OLED_USDS.ino"
+#include "SSD1306_Model.h"
+#include <stdio.h>
+#include <string>
+
+/*****************************************************************************
+  Compares drawing digits in a quarter as Glyph, column by column, with drawing
+  them as QuarterGlyph, pre-split over the quarter's two pages (GLYPH_PRESPLIT),
+  and prints the cycles and bytes per digit and the program memory of the
+  digit tables. Both must draw the same pixels. Build and run from the
+  sketch's directory, with GLYPH_PRESPLIT to compare both:
+
+    g++ -std=gnu++17 -DGLYPH_PRESPLIT=1 -DGLYPH_COUNTED=1 -DUSI_TWI_COUNTED=1 -Ihost -I. -x c++ host/glyph_benchmark.cpp -x none *.cpp -o glyph_benchmark
+    ./glyph_benchmark
+
+  The cycles come in two parts. The emulator charges register accesses and
+  delays: a pre-split digit goes out as one burst, checking the bus state
+  once rather than for every byte. The CPU work on each column is counted by
+  host::Cycles (see AvrCycles.h): reading it from flash, and for a Glyph
+  splitting it over the two pages, with GLYPH_COUNTED, and sending its bytes,
+  with USI_TWI_COUNTED. The jump on the column in Glyph::seg() and calls
+  aren't charged, so the counted cycles of a Glyph are a lower bound.
+****************************************************************************/
+
+using Panel = OLED_PANEL<0x3C>;
+using Quarter = GlyphsOnQuarter<Panel>;
+
+static host::SSD1306_Model oled;
+
+static I2C::Status clear() {
+  return OLED::Chat<Panel> {0}
+  .init()
+  .set_addressing_mode(OLED::VerticalAddressing)
+  .set_column_address()
+  .set_page_address()
+  .set_enabled()
+  .start_data()
+  .sendN(OLED::BYTES, 0)
+  .stop();
+}
+
+struct Cost {
+  unsigned long bytes;    // on the bus
+  unsigned long emulated; // register accesses and delays
+  unsigned long counted;  // work on the columns, from host::Cycles
+};
+
+// Draw the 16 hex digits in quarter A, in one transaction, or none, and tell what that took.
+template <typename Digit>
+static Cost draw(uint8_t digits) {
+  host::Emulator& emu = host::emulator();
+  emu.flush();
+  emu.transactions.clear();
+  Quarter quarter {0, OLED::Quarter::A, 0, OLED::WIDTH - 1, OLED::Heartbeat::None};
+  host::avr_cycles() = 0;
+  for (uint8_t digit = 0; digit < digits; ++digit) {
+    quarter.send(Digit::hex_digit_lo(digit), Glyph::DIGIT_MARGIN);
+  }
+  quarter.stop();
+  unsigned long const counted = host::avr_cycles();
+  emu.flush();
+  host::BusStats const& transaction = emu.transactions.back();
+  return Cost{transaction.bytes, transaction.cycles, counted};
+}
+
+// Print the cost per digit, and return the pixels drawn.
+template <typename Digit>
+static std::string measure(char const* name) {
+  clear();
+  Cost const none = draw<Digit>(0);
+  Cost const all = draw<Digit>(16);
+  double const emulated = double(all.emulated - none.emulated) / 16;
+  double const counted = double(all.counted - none.counted) / 16;
+  printf("%-12s %9.1f %9.1f %9.1f %9.1f %9u\n", name,
+         emulated, counted, emulated + counted, double(all.bytes - none.bytes) / 16,
+         unsigned(sizeof Digit::dec_digit + sizeof Digit::ABCDEF));
+  return oled.pbm();
+}
+
+int main() {
+  host::emulator().attach(oled);
+  I2C::BusOf<Panel>::type::Initialise();
+  if (clear().error) {
+    printf("no display\n");
+    return 1;
+  }
+  printf("%-12s %9s %9s %9s %9s %9s\n", "digits as", "emulated", "counted", "cycles", "bytes", "PROGMEM");
+  std::string const glyphs = measure<Glyph>("Glyph");
+#if GLYPH_PRESPLIT
+  std::string const split = measure<QuarterGlyph>("QuarterGlyph");
+  if (split != glyphs) {
+    printf("QuarterGlyph draws different pixels\n");
+    return 1;
+  }
+#else
+  printf("build with -DGLYPH_PRESPLIT=1 to compare QuarterGlyph\n");
+#endif
+  return 0;
+}
@@ -0,0 +1,147 @@
+#include "ATtiny85_OLED_USDS.ino"
+#include "SSD1306_Model.h"
+#include <stdio.h>
+#include <string.h>
+#include <string>
+
+/*****************************************************************************
+  Draws every glyph, glyph pair, label and formatter of GlyphsOnQuarter on the
+  emulated display, and compares display RAM with the golden images in
+  host/golden. Build and run from the sketch's directory, also with
+  -DGLYPH_PRESPLIT=1, which must not change a pixel:
+
+    g++ -std=gnu++17 -Ihost -I. -x c++ host/golden_images.cpp -x none *.cpp -o golden_images
+    ./golden_images
+
+  Run with --update to write the images instead, then check them with an image
+  viewer before committing them.
+****************************************************************************/
+
+using Panel = OLED_PANEL<0x3C>;
+using Quarter = GlyphsOnQuarter<Panel>;
+
+static host::SSD1306_Model oled;
+
+static I2C::Status clear() {
+  return OLED::Chat<Panel> {0}
+  .init()
+  .set_addressing_mode(OLED::VerticalAddressing)
+  .set_column_address()
+  .set_page_address()
+  .set_enabled()
+  .start_data()
+  .sendN(OLED::BYTES, 0)
+  .stop();
+}
+
+// Each glyph on its own, with a digit's margins.
+static void glyphs() {
+  Quarter a {0, OLED::Quarter::A, 0, OLED::WIDTH - 1, OLED::Heartbeat::None};
+  for (Glyph const& digit : Glyph::dec_digit) a.send(digit, Glyph::DIGIT_MARGIN);
+  a.stop();
+  Quarter b {0, OLED::Quarter::B, 0, OLED::WIDTH - 1, OLED::Heartbeat::None};
+  for (Glyph const& letter : Glyph::ABCDEF) b.send(letter, Glyph::DIGIT_MARGIN);
+  b.send(Glyph::X, Glyph::DIGIT_MARGIN).send(Glyph::at, Glyph::DIGIT_MARGIN).send(Glyph::plus, Glyph::DIGIT_MARGIN);
+  b.stop();
+  Quarter c {0, OLED::Quarter::C, 0, OLED::WIDTH - 1, OLED::Heartbeat::None};
+  for (GlyphPair const* pair : { &GlyphPair::cm, &GlyphPair::m, &GlyphPair::err, &GlyphPair::pin }) {
+    c.send(pair->left).send(pair->right).send(0, 2);
+  }
+  c.sendColon().sendPoint().send(Glyph::MINUS_SEG, Glyph::DIGIT_WIDTH);
+  c.stop();
+  Quarter d {0, OLED::Quarter::D, 0, OLED::WIDTH - 1, OLED::Heartbeat::None};
+  d.send(ERROR_LABEL).send(AT_LABEL).send(METER_LABEL);
+  d.stop();
+}
+
+// The formatters, including blanks, points, overflow and negative numbers.
+static void numbers() {
+  Quarter {0, OLED::Quarter::A, 0, OLED::WIDTH - 1, OLED::Heartbeat::None} .send3dec(7).send(0, 4).send3dec(42).send(0, 4).send3dec(255).stop();
+  Quarter {0, OLED::Quarter::B, 0, OLED::WIDTH - 1, OLED::Heartbeat::None} .send4dec(-1).send4dec(305).send(0, 4).send4dec(9999).stop();
+  Quarter {0, OLED::Quarter::C, 0, OLED::WIDTH - 1, OLED::Heartbeat::None}
+  .send2hex(0x0A).send4hex(0xBEEF).sendNumber<10, 5, 3, false, 3>(1234567UL).stop();
+  Quarter {0, OLED::Quarter::D, 0, OLED::WIDTH - 1, OLED::Heartbeat::None}
+  .sendNumber<10, 4>(12345U).send(0, 4).sendNumber<10, 5, 3, false, 3>(499UL).stop();
+}
+
+// Lines formatted once, drawn through caches as the sketch does: what changed
+// after the first frame, and a line growing and shrinking, must end up the same
+// as if drawn on a clear display. And text in the proportional font.
+static void lines() {
+  static GlyphCache<10> cache_a;
+  static GlyphCache<6> cache_b;
+  for (uint32_t micrometers : { 0UL, 1999999UL, 1234567UL }) {
+    MillimeterLine line;
+    line.sendNumber<10, 5, 3, false, 3>(micrometers + 500);
+    line.send(METER_LABEL);
+    Quarter {10, OLED::Quarter::A, cache_a, 0, 80} .send(line).stop();
+  }
+  for (uint16_t value : { 0xFFFF, 0x12, 0xABCD }) {
+    BytesLine line;
+    line.send2hex(uint8_t(value >> 8));
+    if (value > 0xFF) line.send2hex(uint8_t(value));
+    Quarter {20, OLED::Quarter::B, cache_b, 60, OLED::WIDTH - 1, OLED::Heartbeat::None} .send(line).stop();
+  }
+  ErrorLine error;
+  error.send(ERROR_LABEL).send3dec(3).send(AT_LABEL).send3dec(120);
+  Quarter {0, OLED::Quarter::C} .send(error).stop();
+  Quarter {0, OLED::Quarter::D, 0, OLED::WIDTH - 1, OLED::Heartbeat::None} .send(TEXT_FONT, "2468 ABCDEF@").stop();
+}
+
+// Glyphs stretched over several pages.
+static void scaled() {
+  GlyphsOnPages<Panel, 4, 2> {0, 0, 0, OLED::WIDTH - 1, OLED::Heartbeat::None} .sendNumber<10, 3, 1>(15U).send(TEXT_FONT, "@").stop();
+  GlyphLine<3, 4> line;
+  line.sendNumber<10, 3, 0, false, 4>(423456UL);
+  GlyphsOnPages<Panel, 4, 4> {0, 4, 0, OLED::WIDTH - 1, OLED::Heartbeat::None} .send(line).stop();
+}
+
+static void big() {
+  GlyphsOnPages<Panel, 8, 8> {0, 0, 24, OLED::WIDTH - 1, OLED::Heartbeat::None} .send(Glyph::dec_digit[8]).stop();
+}
+
+static std::string load(std::string const& path) {
+  std::string s;
+  if (FILE* f = fopen(path.c_str(), "r")) {
+    char buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof buf, f)) > 0) s.append(buf, n);
+    fclose(f);
+  }
+  return s;
+}
+
+int main(int argc, char** argv) {
+  bool const update = argc > 1 && strcmp(argv[1], "--update") == 0;
+  struct {
+    char const* name;
+    void (*draw)();
+  } const images[] = {
+    { "glyphs", glyphs }, { "numbers", numbers }, { "lines", lines }, { "scaled", scaled }, { "big", big }
+  };
+  host::emulator().attach(oled);
+  I2C::BusOf<Panel>::type::Initialise();
+  int failed = 0;
+  for (auto const& image : images) {
+    if (clear().error) {
+      printf("no display\n");
+      return 1;
+    }
+    image.draw();
+    I2C::result<Panel>(); // with USI_TWI_ASYNC, until the last frame went out
+    host::emulator().flush();
+    std::string const path = std::string("host/golden/") + image.name + ".pbm";
+    std::string const drawn = oled.pbm();
+    if (update) {
+      oled.save(path.c_str(), drawn);
+      printf("%s written\n", path.c_str());
+    } else if (drawn == load(path)) {
+      printf("%s ok\n", image.name);
+    } else {
+      oled.save((std::string(image.name) + ".pbm").c_str(), drawn);
+      printf("%s differs from %s, see %s.pbm\n", image.name, path.c_str(), image.name);
+      ++failed;
+    }
+  }
+  return failed;
+}
@@ -0,0 +1,125 @@
+#include "ATtiny85_OLED_USDS.ino"
+#include "SSD1306_Model.h"
+#include "USDS_Model.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/*****************************************************************************
+  Runs the sketch on the emulated bus, with a display and a sensor attached,
+  for sensors that take 20, 60 and 150 ms to range, and prints where the time
+  of a sample goes: awake, asleep in idle mode at full speed or on a
+  prescaled clock, and powered down. From that, and the ATtiny85's typical
+  supply currents at 16 MHz and 5 V, it models the average current of the
+  MCU, not counting the display's nor the sensor's. Build and run from the
+  sketch's directory, e.g. for 100 samples each:
+
+    g++ -std=gnu++17 -DUSI_TWI_COUNTED=1 -DGLYPH_COUNTED=1 -DFILTER_COUNTED=1 -Ihost -I. -x c++ host/power_report.cpp -x none *.cpp -o power_report
+    ./power_report 100
+
+  The time awake comes in two parts. The emulator charges register accesses,
+  delays, reading the time and the wake-up from power-down. The CPU work on
+  the bus, the glyphs, the digits and the filter is counted by host::Cycles
+  (see AvrCycles.h), which the counted builds charge for it. That work would
+  push the rest of the sample back, so it lengthens the sample rather than
+  shortening the sleep. Calls, branches of the sketch's own control flow and
+  the scheduler aren't charged, so the awake time is still a lower bound,
+  though now of the same work that the engine benchmarks count.
+****************************************************************************/
+
+#if !USI_TWI_COUNTED || !GLYPH_COUNTED || !FILTER_COUNTED
+#error "build with -DUSI_TWI_COUNTED=1 -DGLYPH_COUNTED=1 -DFILTER_COUNTED=1"
+#endif
+
+// Typical supply currents, in mA, from the datasheet's graphs at 5 V.
+static double constexpr ACTIVE_MA = 9.0;       // active at 16 MHz, on the PLL
+static double constexpr IDLE_MA = 2.5;         // idle at 16 MHz, on the PLL
+static double constexpr POWER_DOWN_MA = 0.010; // powered down, with the watchdog running
+
+// A person standing still, at 800 mm.
+static uint32_t standing(unsigned long) {
+  return 800000;
+}
+
+struct Shares {
+  unsigned long emulated = 0;     // cycles awake, as the emulator charges them
+  unsigned long counted = 0;      // and as host::Cycles counts the work on top
+  unsigned long idle = 0;         // asleep in idle mode, at full speed
+  unsigned long prescaled = 0;    // asleep in idle mode, on a prescaled clock
+  double prescaled_ma = 0;        // the current of those, modelled as scaling with the clock
+  unsigned long powered_down = 0; // asleep in power-down
+
+  unsigned long total() const {
+    return emulated + counted + idle + prescaled + powered_down;
+  }
+};
+
+// Run the sketch for a number of samples and tell where the time went.
+static Shares measure(host::USDS_Model const& usds, unsigned long samples) {
+  host::Emulator& emu = host::emulator();
+  unsigned long const clock = emu.clock, slept = emu.slept, powered_down = emu.powered_down;
+  unsigned long idle_slept[9];
+  for (uint8_t shift = 0; shift < 9; ++shift) {
+    idle_slept[shift] = emu.idle_slept[shift];
+  }
+  host::avr_cycles() = 0;
+  unsigned long const first = usds.orders;
+  while (usds.orders < first + samples) {
+    loop();
+    emu.flush();
+    emu.transactions.clear();
+  }
+
+  Shares shares;
+  shares.emulated = (emu.clock - clock) - (emu.slept - slept);
+  shares.counted = host::avr_cycles();
+  shares.idle = emu.idle_slept[0] - idle_slept[0];
+  for (uint8_t shift = 1; shift < 9; ++shift) {
+    unsigned long const cycles = emu.idle_slept[shift] - idle_slept[shift];
+    shares.prescaled += cycles;
+    shares.prescaled_ma += IDLE_MA / (1 << shift) * cycles;
+  }
+  shares.prescaled_ma /= shares.prescaled ? shares.prescaled : 1;
+  shares.powered_down = emu.powered_down - powered_down;
+  return shares;
+}
+
+static double percent(unsigned long cycles, Shares const& shares) {
+  return 100.0 * cycles / shares.total();
+}
+
+// The average current, with the prescaled naps drawing prescaled_ma.
+static double average_ma(Shares const& shares, double prescaled_ma) {
+  return (ACTIVE_MA * (shares.emulated + shares.counted) + IDLE_MA * shares.idle
+          + prescaled_ma * shares.prescaled + POWER_DOWN_MA * shares.powered_down) / shares.total();
+}
+
+int main(int argc, char** argv) {
+  unsigned long const samples = argc > 1 ? strtoul(argv[1], nullptr, 10) : 50;
+  host::Emulator& emu = host::emulator();
+  host::SSD1306_Model oled;
+  host::USDS_Model usds(standing);
+  emu.attach(oled);
+  emu.attach(usds);
+  setup();
+
+  printf("%8s %7s %7s %7s %7s %7s %7s %11s %12s\n", "ranging", "sample", "awake", "counted",
+         "idle", "slower", "down", "average", "idle-only");
+  for (unsigned long ranging_ms : {20ul, 60ul, 150ul}) {
+    usds.ranging_cycles = ranging_ms * (F_CPU / 1000);
+    measure(usds, 10); // for the schedule to learn the ranging time
+    Shares const shares = measure(usds, samples);
+    // As if the prescaled naps drew as much as at full speed, e.g. for the PLL running on.
+    double const most_ma = average_ma(shares, IDLE_MA);
+    // As if only ever asleep in idle mode at full speed.
+    double const idling_ma = (ACTIVE_MA * (shares.emulated + shares.counted)
+                              + IDLE_MA * (shares.idle + shares.prescaled + shares.powered_down)) / shares.total();
+    printf("%5lu ms %4lu ms %6.2f%% %6.2f%% %6.2f%% %6.2f%% %6.2f%% %4.2f-%.2f mA %9.2f mA\n", ranging_ms,
+           shares.total() / samples / (F_CPU / 1000), percent(shares.emulated + shares.counted, shares),
+           percent(shares.counted, shares), percent(shares.idle, shares), percent(shares.prescaled, shares),
+           percent(shares.powered_down, shares), average_ma(shares, shares.prescaled_ma), most_ma, idling_ma);
+  }
+  printf("modelled at %.1f mA awake, %.1f mA idle and %.0f uA powered down; idle on a prescaled clock\n"
+         "in proportion to the clock, or at most as at full speed; idle-only if every sleep were idle\n",
+         ACTIVE_MA, IDLE_MA, POWER_DOWN_MA * 1000);
+  return 0;
+}
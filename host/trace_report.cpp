@@ -0,0 +1,111 @@
+#include "ATtiny85_OLED_USDS.ino"
+#include "SSD1306_Model.h"
+#include "USDS_Model.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/*****************************************************************************
+  Runs the sketch on the emulated bus, with a display and a sensor attached,
+  and prints the trace that USI_TWI_TRACE records, read back through
+  USI_TWI_Trace_Count() and USI_TWI_Trace_At(): for each sample, from one
+  order to the next, every record of the ring that started meanwhile, then
+  where the time went: on the bus with either device, asleep, and awake
+  between transactions, i.e. filtering and formatting. Time is in µs, at the
+  trace's resolution of 4 µs, and counts with Timer0 like the trace, so that
+  time powered down is left out and shown apart, and time napping on a
+  prescaled clock shrinks by the prescaler. Attempts that the sensor didn't acknowledge
+  count as retries of the next read, so its record spans the naps in
+  between. Build and run from the sketch's directory, e.g. for 5 samples:
+
+    g++ -std=gnu++17 -DUSI_TWI_TRACE=1 -Ihost -I. -x c++ host/trace_report.cpp -x none *.cpp -o trace_report
+    ./trace_report 5
+****************************************************************************/
+
+#if !USI_TWI_TRACE
+#error "build with -DUSI_TWI_TRACE=1"
+#endif
+
+// A person walking up to the sensor.
+static uint32_t approaching(unsigned long n) {
+  return n < 200 ? 1500000 - 5000 * n : 500000;
+}
+
+static uint16_t ticks() {
+  return uint16_t(micros() >> 2);
+}
+
+static unsigned long us(unsigned long ticks) {
+  return 4 * ticks;
+}
+
+// Cycles asleep that Timer0 counted.
+static unsigned long counted_asleep(host::Emulator const& emu) {
+  unsigned long cycles = 0;
+  for (uint8_t shift = 0; shift < 9; ++shift) {
+    cycles += emu.idle_slept[shift] >> shift;
+  }
+  return cycles;
+}
+
+int main(int argc, char** argv) {
+  unsigned long const samples = argc > 1 ? strtoul(argv[1], nullptr, 10) : 3;
+  host::Emulator& emu = host::emulator();
+  host::SSD1306_Model oled;
+  host::USDS_Model usds(approaching);
+  emu.attach(oled);
+  emu.attach(usds);
+  uint8_t const display = PANELS::apply<AddressOf>(0);
+  uint8_t const sensor = SENSORS::apply<AddressOf>(0);
+
+  setup();
+  unsigned long orders = usds.orders;
+  while (usds.orders == orders) {
+    loop();
+  }
+  for (unsigned long sample = 0; sample < samples; ++sample) {
+    orders = usds.orders;
+    uint16_t const begin = ticks();
+    unsigned long const slept = counted_asleep(emu);
+    unsigned long const powered_down = emu.powered_down;
+    while (usds.orders == orders) {
+      loop();
+    }
+    uint16_t const span = ticks() - begin;
+    unsigned long const asleep = us((counted_asleep(emu) - slept) / (F_CPU / 250000));
+
+    printf("sample %lu: %lu us, and %lu us powered down\n", sample + 1, us(span),
+           (emu.powered_down - powered_down) / (F_CPU / 1000000));
+    printf("  %6s %6s %6s %2s %5s %7s %5s\n", "start", "after", "took", "to", "bytes", "retries", "error");
+    unsigned long on_bus[2] = {0, 0}; // display, sensor
+    unsigned long other = 0;
+    unsigned char records = 0;
+    uint16_t end = 0;
+    for (unsigned char i = 0; i < USI_TWI_Trace_Count(); ++i) {
+      USI_TWI_Trace_Record const& record = USI_TWI_Trace_At(i);
+      uint16_t const start = record.start - begin;
+      if (start >= span) continue; // before this sample
+      printf("  %6lu %6lu %6lu %02X %5u %7u %5u\n", us(start), records ? us(uint16_t(start - end)) : 0,
+             us(record.duration), record.address, record.bytes, record.retries, record.error);
+      if (record.address == display) {
+        on_bus[0] += record.duration;
+      } else if (record.address == sensor) {
+        on_bus[1] += record.duration;
+      } else {
+        other += record.duration;
+      }
+      end = start + record.duration;
+      ++records;
+    }
+    if (records == USI_TWI_TRACE_RECORDS) {
+      printf("  (the ring is full: earlier transactions of this sample may be missing)\n");
+    }
+    unsigned long const bus = us(on_bus[0] + on_bus[1] + other);
+    printf("  on the bus: display %lu us, sensor %lu us, other %lu us; asleep %lu us",
+           us(on_bus[0]), us(on_bus[1]), us(other), asleep);
+    if (us(span) >= bus + asleep) {
+      printf("; awake between %lu us\n", us(span) - bus - asleep);
+    } else {
+      printf(", partly while the sensor's retries were traced\n");
+    }
+  }
+}
@@ -0,0 +1,9 @@
+#pragma once
+#include <stdint.h>
+#include "../USI_Emulator.h"
+
+// Host stand-in for <util/delay_basic.h>: 3 cycles per iteration, 256 iterations for 0.
+
+inline void _delay_loop_1(uint8_t count) {
+  ::host::emulator().delay_cycles(count ? 3u * count : 3u * 256);
+}